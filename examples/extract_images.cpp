@@ -0,0 +1,30 @@
+// Exports every image payload (Types 3-8 and tagged ".999" data) of one or
+// more transaction files into an output directory.
+//
+//   nnist_extract <output-dir> <file.an2> [file.an2 ...]
+#include <nnist/nnist.h>
+
+#include <cstdio>
+#include <exception>
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <output-dir> <file.an2>...\n",
+                     argv[0]);
+        return 2;
+    }
+
+    int failures = 0;
+    for (int i = 2; i < argc; i++) {
+        try {
+            for (const auto& image : nnist::EXTRACT_IMAGES(argv[i], argv[1])) {
+                std::printf("%s\t%zu\n", image.path.string().c_str(),
+                            image.payload.length);
+            }
+        } catch (const std::exception& error) {
+            std::fprintf(stderr, "%s: %s\n", argv[i], error.what());
+            ++failures;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
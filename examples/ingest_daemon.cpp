@@ -0,0 +1,87 @@
+// Reference ingest daemon: receives length-framed transactions on a Unix
+// domain socket (or localhost TCP with a port number), validates and parses
+// them on a worker pool and prints throughput and latency once a second.
+//
+//   nnist_ingestd <socket-path | tcp-port> [workers] [queue-capacity]
+#include <nnist/nnist.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <thread>
+
+namespace {
+    volatile std::sig_atomic_t STOP = 0;
+
+    void ON_SIGNAL(int) { STOP = 1; }
+
+    bool IS_PORT(const std::string& text) {
+        return !text.empty() &&
+               text.find_first_not_of("0123456789") == std::string::npos;
+    }
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr,
+                     "usage: %s <socket-path | tcp-port> [workers] "
+                     "[queue-capacity]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    nnist::IngestOptions options;
+    if (IS_PORT(argv[1])) {
+        options.tcp_port = static_cast<uint16_t>(std::stoul(argv[1]));
+    } else {
+        options.unix_path = argv[1];
+    }
+    if (argc > 2) {
+        options.worker_count = std::stoul(argv[2]);
+    }
+    if (argc > 3) {
+        options.queue_capacity = std::stoul(argv[3]);
+    }
+
+    std::signal(SIGINT, ON_SIGNAL);
+    std::signal(SIGTERM, ON_SIGNAL);
+
+    try {
+        nnist::IngestServer server(options);
+        if (options.unix_path.empty()) {
+            std::printf("listening on 127.0.0.1:%u\n", server.port());
+        } else {
+            std::printf("listening on %s\n", options.unix_path.c_str());
+        }
+        std::fflush(stdout);
+
+        nnist::IngestStats last;
+        while (STOP == 0) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            const nnist::IngestStats now = server.stats();
+            const auto& latency = server.latency();
+            constexpr double MICROSECONDS = 1e3;
+            std::printf(
+                "frames/s %llu  MB/s %.1f  accepted %llu  rejected %llu  "
+                "pauses %llu  p50 %.0fus  p99 %.0fus  p99.9 %.0fus\n",
+                static_cast<unsigned long long>(now.frames - last.frames),
+                static_cast<double>(now.bytes - last.bytes) / 1e6,
+                static_cast<unsigned long long>(now.accepted),
+                static_cast<unsigned long long>(now.rejected),
+                static_cast<unsigned long long>(now.pauses),
+                static_cast<double>(latency.percentile(0.5)) / MICROSECONDS,
+                static_cast<double>(latency.percentile(0.99)) / MICROSECONDS,
+                static_cast<double>(latency.percentile(0.999)) /
+                    MICROSECONDS);
+            std::fflush(stdout);
+            last = now;
+        }
+    } catch (const std::exception& error) {
+        std::fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+    return 0;
+}
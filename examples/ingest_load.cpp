@@ -0,0 +1,112 @@
+// Load generator for nnist_ingestd: opens several connections, each keeping
+// a window of requests in flight, and reports throughput and round-trip
+// latency percentiles.
+//
+//   nnist_ingest_load <socket-path | tcp-port> <file.an2> [connections]
+//                     [requests-per-connection] [window]
+#include <nnist/nnist.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr,
+                     "usage: %s <socket-path | tcp-port> <file.an2> "
+                     "[connections] [requests] [window]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    const std::string target = argv[1];
+    const bool tcp = target.find_first_not_of("0123456789") ==
+                     std::string::npos;
+    const size_t connections = argc > 3 ? std::stoul(argv[3]) : 4U;
+    const size_t requests = argc > 4 ? std::stoul(argv[4]) : 10000U;
+    const size_t window = argc > 5 ? std::stoul(argv[5]) : 16U;
+
+    using Clock = std::chrono::steady_clock;
+    try {
+        const auto transaction = nnist::READ_FILE(argv[2]);
+        nnist::LatencyHistogram latency;
+        std::atomic<uint64_t> rejected{0U};
+        std::atomic<uint64_t> completed{0U};
+        // One slot per connection; a thread's exception cannot reach the
+        // outer handler, so it is kept here and reported after join().
+        std::vector<std::string> failures(connections);
+
+        const auto started = Clock::now();
+        std::vector<std::thread> threads;
+        for (size_t c = 0; c < connections; c++) {
+            threads.emplace_back([&, c]() {
+                try {
+                    auto client =
+                        tcp ? std::make_unique<nnist::IngestClient>(
+                                  static_cast<uint16_t>(std::stoul(target)))
+                            : std::make_unique<nnist::IngestClient>(target);
+                    std::vector<Clock::time_point> sent(requests);
+                    size_t next = 0U;
+                    for (size_t done = 0; done < requests; done++) {
+                        while (next < requests && next - done < window) {
+                            sent[next++] = Clock::now();
+                            client->send(transaction);
+                        }
+                        const nnist::IngestReply reply = client->receive();
+                        latency.record(static_cast<uint64_t>(
+                            std::chrono::duration_cast<
+                                std::chrono::nanoseconds>(
+                                Clock::now() - sent[reply.sequence])
+                                .count()));
+                        completed.fetch_add(1U, std::memory_order_relaxed);
+                        if (reply.status != nnist::INGEST_ACCEPTED) {
+                            rejected.fetch_add(1U, std::memory_order_relaxed);
+                        }
+                    }
+                } catch (const std::exception& error) {
+                    failures[c] = error.what();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        size_t failed = 0U;
+        for (size_t c = 0; c < connections; c++) {
+            if (!failures[c].empty()) {
+                std::fprintf(stderr, "connection %zu: %s\n", c,
+                             failures[c].c_str());
+                ++failed;
+            }
+        }
+
+        const double seconds =
+            std::chrono::duration<double>(Clock::now() - started).count();
+        const auto total = static_cast<double>(completed.load());
+        constexpr double MICROSECONDS = 1e3;
+        std::printf(
+            "%.0f requests in %.2fs: %.0f req/s, %.1f MB/s, %llu rejected\n"
+            "round trip p50 %.0fus  p99 %.0fus  p99.9 %.0fus\n",
+            total, seconds, total / seconds,
+            total * static_cast<double>(transaction.size()) / seconds / 1e6,
+            static_cast<unsigned long long>(rejected.load()),
+            static_cast<double>(latency.percentile(0.5)) / MICROSECONDS,
+            static_cast<double>(latency.percentile(0.99)) / MICROSECONDS,
+            static_cast<double>(latency.percentile(0.999)) / MICROSECONDS);
+        if (failed > 0U) {
+            std::fprintf(stderr, "%zu of %zu connections failed\n", failed,
+                         connections);
+            return 1;
+        }
+    } catch (const std::exception& error) {
+        std::fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,272 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "nnist/hash.h"
+#include "nnist/parsers.h"
+#include "nnist/serdes.h"
+#include "nnist/types.h"
+
+namespace nnist {
+
+    constexpr size_t DEFAULT_CACHE_SHARDS = 16U;
+
+    // Heap bytes held by a parsed File, counted from container capacities.
+    inline size_t FILE_FOOTPRINT(const File& file) noexcept {
+        size_t bytes = sizeof(File) + file.records.capacity() * sizeof(Record);
+        for (const Record& record : file.records) {
+            bytes += record.raw_record.capacity() +
+                     record.fields.capacity() * sizeof(Field);
+            for (const Field& field : record.fields) {
+                bytes += field.raw_field.capacity() + field.tag.capacity() +
+                         field.subfields.capacity() * sizeof(Subfield);
+                for (const Subfield& subfield : field.subfields) {
+                    bytes += subfield.items.capacity() * sizeof(Item);
+                    for (const Item& item : subfield.items) {
+                        bytes += item.bytes.capacity();
+                    }
+                }
+            }
+        }
+        return bytes;
+    }
+
+    struct ParseCacheStats {
+        uint64_t hits = 0U;
+        uint64_t misses = 0U;
+        uint64_t evictions = 0U;
+        size_t entries = 0U;
+        size_t bytes = 0U;  // FILE_FOOTPRINT + input size of everything cached
+    };
+
+    // --------------------------------------------
+    // Content-Addressed Parse Cache
+    // --------------------------------------------
+    // A cached File and the copy of the input it was parsed from. The
+    // File's source spans index `bytes`, so SERIALIZE_FILE(file, bytes)
+    // re-emits unedited records verbatim.
+    struct CachedTransaction {
+        std::vector<uint8_t> bytes;
+        File file;
+    };
+
+    // Parsed transactions keyed by HASH_BYTES of their input plus its
+    // length, so a repeated submission costs one hash and one compare
+    // instead of a parse. The hash only picks the entry: each entry keeps
+    // the copy of its input the File was parsed from, and a hit needs the
+    // bytes to match, so a hash collision is a miss rather than another
+    // submitter's File. Results are immutable and shared; an evicted
+    // result stays alive while a caller still holds it. The byte budget is
+    // split across shards, each with its own lock and LRU list, so
+    // concurrent lookups of different inputs rarely contend. Parsing
+    // happens outside the lock. A result larger than one shard's budget is
+    // returned but not cached.
+    class ParseCache {
+      public:
+        explicit ParseCache(size_t byte_budget,
+                            size_t shard_count = DEFAULT_CACHE_SHARDS)
+            : shards_(shard_count == 0U ? 1U : shard_count),
+              shard_budget_(byte_budget / shards_.size()) {}
+
+        ParseCache(const ParseCache&) = delete;
+        ParseCache& operator=(const ParseCache&) = delete;
+
+        // The cached result for `buffer`, or null.
+        [[nodiscard]] std::shared_ptr<const CachedTransaction> find(
+            std::span<const uint8_t> buffer) {
+            const Key key = KEY_OF(buffer);
+            auto result = lookup(key, buffer);
+            (result ? hits_ : misses_).fetch_add(1U, std::memory_order_relaxed);
+            return result;
+        }
+
+        // The cached result for `buffer`, parsing a copy of it and caching
+        // that on a miss. Throws as PARSE_FILE does; failures are not
+        // cached.
+        std::shared_ptr<const CachedTransaction> parse(
+            std::span<const uint8_t> buffer) {
+            const Key key = KEY_OF(buffer);
+            if (auto cached = lookup(key, buffer)) {
+                hits_.fetch_add(1U, std::memory_order_relaxed);
+                return cached;
+            }
+            return parse_miss(key, {buffer.begin(), buffer.end()});
+        }
+
+        // READ_FILE + parse(); the bytes are read either way, the parse is
+        // skipped on a hit. On a miss the read buffer itself is kept.
+        std::shared_ptr<const CachedTransaction> read(
+            const std::filesystem::path& path) {
+            std::vector<uint8_t> bytes = READ_FILE(path);
+            const Key key = KEY_OF(bytes);
+            if (auto cached = lookup(key, bytes)) {
+                hits_.fetch_add(1U, std::memory_order_relaxed);
+                return cached;
+            }
+            return parse_miss(key, std::move(bytes));
+        }
+
+        [[nodiscard]] ParseCacheStats stats() const {
+            ParseCacheStats stats;
+            stats.hits = hits_.load(std::memory_order_relaxed);
+            stats.misses = misses_.load(std::memory_order_relaxed);
+            stats.evictions = evictions_.load(std::memory_order_relaxed);
+            for (const Shard& shard : shards_) {
+                const std::lock_guard<std::mutex> lock(shard.mutex);
+                stats.entries += shard.entries.size();
+                stats.bytes += shard.bytes;
+            }
+            return stats;
+        }
+
+        void clear() {
+            for (Shard& shard : shards_) {
+                const std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.index.clear();
+                shard.entries.clear();
+                shard.bytes = 0U;
+            }
+        }
+
+      private:
+        struct Key {
+            uint64_t hash = 0U;
+            size_t length = 0U;
+
+            bool operator==(const Key&) const = default;
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& key) const noexcept {
+                return static_cast<size_t>(key.hash);
+            }
+        };
+
+        struct Entry {
+            Key key;
+            std::shared_ptr<const CachedTransaction> result;
+            size_t bytes = 0U;
+        };
+
+        static bool SAME_BYTES(const std::vector<uint8_t>& input,
+                               std::span<const uint8_t> buffer) noexcept {
+            return input.size() == buffer.size() &&
+                   (buffer.empty() ||
+                    std::memcmp(input.data(), buffer.data(), buffer.size()) ==
+                        0);
+        }
+
+        // Most recently used entry first.
+        struct Shard {
+            mutable std::mutex mutex;
+            std::list<Entry> entries;
+            std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+            size_t bytes = 0U;
+
+            // The entry under `key`, refreshed as most recent. Its bytes are
+            // compared by the caller, outside the lock.
+            std::shared_ptr<const CachedTransaction> find(const Key& key) {
+                const std::lock_guard<std::mutex> lock(mutex);
+                const auto found = index.find(key);
+                if (found == index.end()) {
+                    return nullptr;
+                }
+                entries.splice(entries.begin(), entries, found->second);
+                return found->second->result;
+            }
+
+            // Another thread may have cached the same input meanwhile; its
+            // result wins so every caller shares one. A different input
+            // under the same key (a collision) is left in place and the new
+            // result is returned uncached.
+            std::shared_ptr<const CachedTransaction> insert(
+                const Key& key, std::shared_ptr<const CachedTransaction> result,
+                size_t footprint, size_t budget,
+                std::atomic<uint64_t>& evictions) {
+                const std::lock_guard<std::mutex> lock(mutex);
+                const auto found = index.find(key);
+                if (found != index.end()) {
+                    if (!SAME_BYTES(found->second->result->bytes,
+                                    result->bytes)) {
+                        return result;
+                    }
+                    entries.splice(entries.begin(), entries, found->second);
+                    return found->second->result;
+                }
+
+                while (!entries.empty() && bytes + footprint > budget) {
+                    bytes -= entries.back().bytes;
+                    index.erase(entries.back().key);
+                    entries.pop_back();
+                    evictions.fetch_add(1U, std::memory_order_relaxed);
+                }
+                entries.push_front({key, result, footprint});
+                index.emplace(key, entries.begin());
+                bytes += footprint;
+                return result;
+            }
+        };
+
+        std::shared_ptr<const CachedTransaction> lookup(
+            const Key& key, std::span<const uint8_t> buffer) {
+            auto result = shard_of(key).find(key);
+            if (result == nullptr || !SAME_BYTES(result->bytes, buffer)) {
+                return nullptr;
+            }
+            return result;
+        }
+
+        // Parses `bytes` where the result will keep them, so the File's
+        // source spans stay valid for as long as it is held.
+        std::shared_ptr<const CachedTransaction> parse_miss(
+            const Key& key, std::vector<uint8_t> bytes) {
+            misses_.fetch_add(1U, std::memory_order_relaxed);
+
+            auto result = std::make_shared<CachedTransaction>();
+            result->bytes = std::move(bytes);
+            const PARSE_STATUS status = PARSE_FILE_INTO(
+                std::span<const uint8_t>(result->bytes), result->file);
+            if (status != PARSE_OK) {
+                throw std::runtime_error(PARSE_STATUS_MESSAGE(status));
+            }
+            const size_t footprint =
+                FILE_FOOTPRINT(result->file) + result->bytes.size();
+            if (footprint > shard_budget_) {
+                return result;
+            }
+            return shard_of(key).insert(key, std::move(result), footprint,
+                                        shard_budget_, evictions_);
+        }
+
+        static Key KEY_OF(std::span<const uint8_t> buffer) noexcept {
+            return {HASH_BYTES(buffer), buffer.size()};
+        }
+
+        Shard& shard_of(const Key& key) noexcept {
+            // The low hash bits pick the bucket inside the shard's map.
+            constexpr uint32_t SHARD_SHIFT = 32U;
+            return shards_[static_cast<size_t>(key.hash >> SHARD_SHIFT) %
+                           shards_.size()];
+        }
+
+        std::vector<Shard> shards_;
+        size_t shard_budget_ = 0U;
+        std::atomic<uint64_t> hits_{0U};
+        std::atomic<uint64_t> misses_{0U};
+        std::atomic<uint64_t> evictions_{0U};
+    };
+
+}  // namespace nnist
+#endif
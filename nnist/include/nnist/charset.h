@@ -0,0 +1,430 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "nnist/constants.h"
+#include "nnist/parsers.h"
+#include "nnist/scan.h"
+#include "nnist/types.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#if !NNIST_FREESTANDING
+#include <string>
+#include <string_view>
+#include <vector>
+#endif
+
+namespace nnist {
+
+    constexpr size_t TYPE1_DCS_FIELD = 15U;  // 1.015 directory of char sets
+    constexpr size_t TEXT_BLOCK = 16U;       // bytes checked per SIMD step
+
+    constexpr uint8_t ASCII_LIMIT = 0x80U;
+    constexpr uint8_t UTF8_CONTINUATION_MIN = 0x80U;
+    constexpr uint8_t UTF8_CONTINUATION_MAX = 0xBFU;
+    constexpr uint8_t UTF8_TWO_BYTE_LEAD = 0xC0U;
+    constexpr uint8_t UTF8_TWO_BYTE_MIN = 0xC2U;
+    constexpr uint8_t UTF8_TWO_BYTE_MAX = 0xDFU;
+    constexpr uint8_t UTF8_THREE_BYTE_E0 = 0xE0U;
+    constexpr uint8_t UTF8_THREE_BYTE_ED = 0xEDU;
+    constexpr uint8_t UTF8_THREE_BYTE_MAX = 0xEFU;
+    constexpr uint8_t UTF8_FOUR_BYTE_F0 = 0xF0U;
+    constexpr uint8_t UTF8_FOUR_BYTE_F4 = 0xF4U;
+    constexpr uint8_t UTF8_E0_SECOND_MIN = 0xA0U;  // no overlong 3-byte forms
+    constexpr uint8_t UTF8_ED_SECOND_MAX = 0x9FU;  // no surrogates
+    constexpr uint8_t UTF8_F0_SECOND_MIN = 0x90U;  // no overlong 4-byte forms
+    constexpr uint8_t UTF8_F4_SECOND_MAX = 0x8FU;  // nothing above U+10FFFF
+    constexpr uint8_t UTF8_PAYLOAD_MASK = 0x3FU;
+    constexpr uint8_t UTF8_LEAD_PAYLOAD_MASK = 0x1FU;
+    constexpr uint32_t UTF8_PAYLOAD_BITS = 6U;
+
+    // Character encoding index of DCS (ANSI/NIST-ITL 1-2007, Table 5).
+    enum TEXT_ENCODING : uint8_t {
+        TEXT_ASCII = 0,   // 000: 7-bit ASCII
+        TEXT_LATIN1 = 1,  // 001: 8-bit ISO 8859-1
+        TEXT_UTF16 = 2,   // 002: 16-bit Unicode
+        TEXT_UTF8 = 3,    // 003: UTF-8
+        TEXT_UNSUPPORTED
+    };
+
+    enum TEXT_STATUS : uint8_t {
+        TEXT_OK = 0,
+        TEXT_NOT_ASCII,          // high byte in a 7-bit ASCII record
+        TEXT_INVALID_UTF8,       // ill-formed UTF-8 sequence
+        TEXT_UNREPRESENTABLE,    // code point above U+00FF for Latin-1
+        TEXT_UNSUPPORTED_ENCODING
+    };
+
+    inline TEXT_ENCODING TEXT_ENCODING_FROM_CSI(size_t index) noexcept {
+        switch (index) {
+            case TEXT_ASCII:
+                return TEXT_ASCII;
+            case TEXT_LATIN1:
+                return TEXT_LATIN1;
+            case TEXT_UTF16:
+                return TEXT_UTF16;
+            case TEXT_UTF8:
+                return TEXT_UTF8;
+            default:
+                return TEXT_UNSUPPORTED;
+        }
+    }
+
+    // Encoding declared by the first DCS entry of a raw Type-1 record (its
+    // exact LEN span). Transactions without 1.015 are 7-bit ASCII.
+    inline TEXT_ENCODING DETECT_TEXT_ENCODING(std::span<const uint8_t> type1) {
+        TEXT_ENCODING encoding = TEXT_ASCII;
+        FOR_EACH_TAGGED_FIELD(type1, [&](const TaggedField& field) {
+            if (field.field_number != TYPE1_DCS_FIELD) {
+                return true;
+            }
+            const size_t end = FIND_DELIMITER(field.value, 0U, US, RS);
+            size_t index = 0U;
+            encoding = PARSE_UNSIGNED(field.value.first(end), index)
+                           ? TEXT_ENCODING_FROM_CSI(index)
+                           : TEXT_UNSUPPORTED;
+            return false;
+        });
+        return encoding;
+    }
+
+    // --------------------------------------------
+    // ASCII Fast Path (SIMD)
+    // --------------------------------------------
+    // True when none of the TEXT_BLOCK bytes at `bytes` has its high bit set.
+    inline bool IS_ASCII_BLOCK(const uint8_t* bytes) noexcept {
+#if defined(__SSE2__)
+        const __m128i block =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+        return _mm_movemask_epi8(block) == 0;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        return vmaxvq_u8(vld1q_u8(bytes)) < ASCII_LIMIT;
+#else
+        constexpr uint64_t HIGH_BITS = 0x8080808080808080ULL;
+        uint64_t low = 0U;
+        uint64_t high = 0U;
+        std::memcpy(&low, bytes, sizeof(low));
+        std::memcpy(&high, bytes + sizeof(low), sizeof(high));
+        return ((low | high) & HIGH_BITS) == 0U;
+#endif
+    }
+
+    // Offset of the first non-ASCII byte at or after `from`, or the size.
+    inline size_t SKIP_ASCII(std::span<const uint8_t> bytes,
+                             size_t from) noexcept {
+        while (from + TEXT_BLOCK <= bytes.size() &&
+               IS_ASCII_BLOCK(bytes.data() + from)) {
+            from += TEXT_BLOCK;
+        }
+        while (from < bytes.size() && bytes[from] < ASCII_LIMIT) {
+            ++from;
+        }
+        return from;
+    }
+
+    inline bool IS_ASCII(std::span<const uint8_t> bytes) noexcept {
+        return SKIP_ASCII(bytes, 0U) == bytes.size();
+    }
+
+    // --------------------------------------------
+    // UTF-8 Validation
+    // --------------------------------------------
+    // Length of the well-formed UTF-8 sequence at `offset` (Unicode Table
+    // 3-7), or 0 when it is ill-formed or truncated.
+    inline size_t UTF8_SEQUENCE_LENGTH(std::span<const uint8_t> bytes,
+                                       size_t offset) noexcept {
+        const uint8_t lead = bytes[offset];
+        uint8_t second_min = UTF8_CONTINUATION_MIN;
+        uint8_t second_max = UTF8_CONTINUATION_MAX;
+        size_t length = 0U;
+
+        if (lead < ASCII_LIMIT) {
+            return 1U;
+        }
+        if (lead >= UTF8_TWO_BYTE_MIN && lead <= UTF8_TWO_BYTE_MAX) {
+            length = 2U;
+        } else if (lead >= UTF8_THREE_BYTE_E0 && lead <= UTF8_THREE_BYTE_MAX) {
+            length = 3U;
+            if (lead == UTF8_THREE_BYTE_E0) {
+                second_min = UTF8_E0_SECOND_MIN;
+            } else if (lead == UTF8_THREE_BYTE_ED) {
+                second_max = UTF8_ED_SECOND_MAX;
+            }
+        } else if (lead >= UTF8_FOUR_BYTE_F0 && lead <= UTF8_FOUR_BYTE_F4) {
+            length = 4U;
+            if (lead == UTF8_FOUR_BYTE_F0) {
+                second_min = UTF8_F0_SECOND_MIN;
+            } else if (lead == UTF8_FOUR_BYTE_F4) {
+                second_max = UTF8_F4_SECOND_MAX;
+            }
+        } else {
+            return 0U;
+        }
+
+        if (length > bytes.size() - offset ||
+            bytes[offset + 1U] < second_min ||
+            bytes[offset + 1U] > second_max) {
+            return 0U;
+        }
+        for (size_t i = 2U; i < length; i++) {
+            if (bytes[offset + i] < UTF8_CONTINUATION_MIN ||
+                bytes[offset + i] > UTF8_CONTINUATION_MAX) {
+                return 0U;
+            }
+        }
+        return length;
+    }
+
+    // Offset of the first ill-formed sequence, or the size when `bytes` is
+    // valid UTF-8. ASCII runs are skipped a block at a time.
+    inline size_t FIND_INVALID_UTF8(std::span<const uint8_t> bytes) noexcept {
+        size_t offset = SKIP_ASCII(bytes, 0U);
+        while (offset < bytes.size()) {
+            const size_t length = UTF8_SEQUENCE_LENGTH(bytes, offset);
+            if (length == 0U) {
+                return offset;
+            }
+            offset = SKIP_ASCII(bytes, offset + length);
+        }
+        return bytes.size();
+    }
+
+    // --------------------------------------------
+    // Latin-1 <-> UTF-8
+    // --------------------------------------------
+    inline size_t LATIN1_AS_UTF8_SIZE(std::span<const uint8_t> bytes) noexcept {
+        size_t size = bytes.size();
+        for (size_t offset = SKIP_ASCII(bytes, 0U); offset < bytes.size();
+             offset = SKIP_ASCII(bytes, offset + 1U)) {
+            ++size;  // every high byte widens to two
+        }
+        return size;
+    }
+
+    // Size of valid UTF-8 `bytes` once written as Latin-1: one byte per
+    // code point (sequences above U+00FF fail while writing).
+    inline size_t UTF8_AS_LATIN1_SIZE(std::span<const uint8_t> bytes) noexcept {
+        size_t size = bytes.size();
+        for (size_t offset = SKIP_ASCII(bytes, 0U); offset < bytes.size();
+             offset = SKIP_ASCII(bytes, offset + 1U)) {
+            if (bytes[offset] <= UTF8_CONTINUATION_MAX) {
+                --size;  // continuation bytes fold into their lead
+            }
+        }
+        return size;
+    }
+
+    // Writes `bytes` as UTF-8 to `out` (LATIN1_AS_UTF8_SIZE bytes); returns
+    // the end of the written range. ASCII runs are copied in bulk.
+    inline uint8_t* WRITE_LATIN1_AS_UTF8(uint8_t* out,
+                                         std::span<const uint8_t> bytes) {
+        size_t offset = 0U;
+        while (offset < bytes.size()) {
+            const size_t run_end = SKIP_ASCII(bytes, offset);
+            if (run_end > offset) {
+                std::memcpy(out, bytes.data() + offset, run_end - offset);
+                out += run_end - offset;
+            }
+            if (run_end >= bytes.size()) {
+                break;
+            }
+            const uint8_t byte = bytes[run_end];
+            *out++ = static_cast<uint8_t>(UTF8_TWO_BYTE_LEAD |
+                                          (byte >> UTF8_PAYLOAD_BITS));
+            *out++ = static_cast<uint8_t>(UTF8_CONTINUATION_MIN |
+                                          (byte & UTF8_PAYLOAD_MASK));
+            offset = run_end + 1U;
+        }
+        return out;
+    }
+
+    // Writes valid UTF-8 `bytes` as Latin-1 to `out` (at most bytes.size()
+    // bytes). Returns nullptr and sets `error_offset` at the first sequence
+    // that is ill-formed or above U+00FF.
+    inline uint8_t* WRITE_UTF8_AS_LATIN1(uint8_t* out,
+                                         std::span<const uint8_t> bytes,
+                                         size_t& error_offset,
+                                         TEXT_STATUS& status) {
+        size_t offset = 0U;
+        while (offset < bytes.size()) {
+            const size_t run_end = SKIP_ASCII(bytes, offset);
+            if (run_end > offset) {
+                std::memcpy(out, bytes.data() + offset, run_end - offset);
+                out += run_end - offset;
+            }
+            if (run_end >= bytes.size()) {
+                break;
+            }
+            const size_t length = UTF8_SEQUENCE_LENGTH(bytes, run_end);
+            if (length != 2U) {
+                error_offset = run_end;
+                status = length == 0U ? TEXT_INVALID_UTF8
+                                      : TEXT_UNREPRESENTABLE;
+                return nullptr;
+            }
+            const uint32_t lead = bytes[run_end] & UTF8_LEAD_PAYLOAD_MASK;
+            if (lead > 3U) {  // U+0100 and above
+                error_offset = run_end;
+                status = TEXT_UNREPRESENTABLE;
+                return nullptr;
+            }
+            *out++ = static_cast<uint8_t>(
+                (lead << UTF8_PAYLOAD_BITS) |
+                (bytes[run_end + 1U] & UTF8_PAYLOAD_MASK));
+            offset = run_end + 2U;
+        }
+        return out;
+    }
+
+#if !NNIST_FREESTANDING
+    // --------------------------------------------
+    // Bulk Record Transcoding (Single Arena)
+    // --------------------------------------------
+    // Result for one record. `text` views either the source record itself
+    // (nothing to convert) or a slice of the arena.
+    struct TranscodedText {
+        TEXT_STATUS status = TEXT_OK;
+        std::span<const uint8_t> text;
+        size_t error_offset = INVALID_INDEX;  // relative to the record
+
+        [[nodiscard]] std::string_view view() const noexcept {
+            return {reinterpret_cast<const char*>(text.data()), text.size()};
+        }
+    };
+
+    // Byte range of the x.001 LEN value leading a tagged record; false when
+    // the record does not start with one.
+    inline bool FIND_LEN_VALUE(std::span<const uint8_t> record, size_t& start,
+                               size_t& end) noexcept {
+        int record_type = -1;
+        size_t length = 0U;
+        if (!READ_TAGGED_HEADER(record, 0U, record_type, length)) {
+            return false;
+        }
+        start = 0U;
+        while (record[start] != ':') {
+            ++start;
+        }
+        end = ++start;
+        while (end < record.size() && record[end] >= '0' &&
+               record[end] <= '9') {
+            ++end;
+        }
+        return true;
+    }
+
+    // Converts whole tagged records (exact LEN spans, e.g. Type-2 from a
+    // RecordLocator) between the DCS encodings. Separators are ASCII, so
+    // each record is transcoded as one run rather than item by item.
+    // All-ASCII records, and records already in the target encoding, are
+    // validated and returned as views of the source without copying. The
+    // rest are written into `arena`, sized once up front so the returned
+    // views stay valid until the arena is next modified. A converted record
+    // that starts with its x.001 LEN gets that LEN rewritten to its new
+    // size, so every result is a valid record; other input is converted
+    // as plain text.
+    inline std::vector<TranscodedText> TRANSCODE_RECORDS(
+        const std::vector<std::span<const uint8_t>>& records,
+        TEXT_ENCODING from, TEXT_ENCODING to, std::vector<uint8_t>& arena) {
+        struct Placement {
+            size_t offset = INVALID_INDEX;  // into the arena
+            size_t len_start = 0U;          // LEN value, source-relative
+            size_t len_end = 0U;
+            size_t length = 0U;  // new LEN; 0 when there is none to rewrite
+        };
+
+        std::vector<TranscodedText> results(records.size());
+        std::vector<Placement> placements(records.size());
+        const bool supported = from <= TEXT_UTF8 && from != TEXT_UTF16 &&
+                               to <= TEXT_UTF8 && to != TEXT_UTF16;
+
+        size_t total = 0U;
+        for (size_t i = 0; i < records.size(); i++) {
+            const auto record = records[i];
+            auto& result = results[i];
+            result.text = record;
+
+            if (!supported) {
+                result.status = TEXT_UNSUPPORTED_ENCODING;
+                continue;
+            }
+            const size_t non_ascii = SKIP_ASCII(record, 0U);
+            if (non_ascii == record.size()) {
+                continue;  // common case: nothing to validate or convert
+            }
+
+            if (from == TEXT_UTF8) {
+                const size_t invalid = FIND_INVALID_UTF8(record);
+                if (invalid != record.size()) {
+                    result.status = TEXT_INVALID_UTF8;
+                    result.error_offset = invalid;
+                    continue;
+                }
+            }
+            if (from == TEXT_ASCII || to == TEXT_ASCII) {
+                result.status = from == TEXT_ASCII ? TEXT_NOT_ASCII
+                                                   : TEXT_UNREPRESENTABLE;
+                result.error_offset = non_ascii;
+            } else if (from != to) {
+                auto& placement = placements[i];
+                size_t size = from == TEXT_LATIN1
+                                  ? LATIN1_AS_UTF8_SIZE(record)
+                                  : UTF8_AS_LATIN1_SIZE(record);
+                if (FIND_LEN_VALUE(record, placement.len_start,
+                                   placement.len_end)) {
+                    placement.length = SELF_COUNTING_LENGTH(
+                        size - (placement.len_end - placement.len_start));
+                    size = placement.length;
+                }
+                placement.offset = total;
+                total += size;
+            }
+        }
+
+        arena.clear();
+        arena.resize(total);
+        for (size_t i = 0; i < records.size(); i++) {
+            const Placement& placement = placements[i];
+            if (placement.offset == INVALID_INDEX) {
+                continue;
+            }
+            uint8_t* start = arena.data() + placement.offset;
+            uint8_t* out = start;
+            auto body = records[i];
+            if (placement.length > 0U) {
+                // The tag is ASCII in every encoding: copy it, then the LEN.
+                std::memcpy(out, body.data(), placement.len_start);
+                out += placement.len_start;
+                const std::string length = std::to_string(placement.length);
+                std::memcpy(out, length.data(), length.size());
+                out += length.size();
+                body = body.subspan(placement.len_end);
+            }
+
+            uint8_t* end = nullptr;
+            if (from == TEXT_LATIN1) {
+                end = WRITE_LATIN1_AS_UTF8(out, body);
+            } else {
+                end = WRITE_UTF8_AS_LATIN1(out, body,
+                                           results[i].error_offset,
+                                           results[i].status);
+            }
+            if (end == nullptr) {
+                results[i].error_offset += records[i].size() - body.size();
+                results[i].text = {};
+                continue;
+            }
+            results[i].text = std::span<const uint8_t>(
+                start, static_cast<size_t>(end - start));
+        }
+        return results;
+    }
+#endif
+
+}  // namespace nnist
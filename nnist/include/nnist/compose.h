@@ -0,0 +1,326 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "nnist/locator.h"
+#include "nnist/parsers.h"
+#include "nnist/scan.h"
+#include "nnist/serdes.h"
+#include "nnist/types.h"
+
+namespace nnist {
+
+    constexpr size_t ASC_FIELD = 995U;  // associated context (Type-21 IDC)
+    constexpr size_t SOR_FIELD = 997U;  // source representation (Type-20)
+    constexpr int MAX_IDC = 255;        // one byte in binary records
+    constexpr int MAX_TAGGED_IDC = 99;  // two digits in tagged xx.002
+
+    // One record to place in a composed transaction. `group` names the IDC
+    // namespace it came from (normally the index of its source transaction):
+    // records sharing a group and an IDC keep sharing their new IDC.
+    struct SourceRecord {
+        std::span<const uint8_t> source;  // the whole source transaction
+        RecordSpan span;
+        size_t group = 0U;
+    };
+
+    // --------------------------------------------
+    // IDC Renumbering
+    // --------------------------------------------
+    // Maps (group, old IDC) to output IDCs in record order. An IDC keeps its
+    // value while it is free, so the first group passes through unchanged;
+    // later collisions take the smallest unused IDC up to `max_idc` (pass
+    // MAX_TAGGED_IDC when the IDC is shared with a tagged record).
+    class IdcMap {
+      public:
+        int assign(size_t group, int idc, int max_idc = MAX_IDC) {
+            const uint64_t key = RECORD_KEY(static_cast<int>(group), idc);
+            const auto found = map_.find(key);
+            if (found != map_.end()) {
+                return found->second;
+            }
+
+            int next = idc;
+            if (next < 0 || next > MAX_IDC ||
+                used_[static_cast<size_t>(next)]) {
+                next = 1;
+                while (next <= max_idc && used_[static_cast<size_t>(next)]) {
+                    ++next;
+                }
+                if (next > max_idc) {
+                    throw std::runtime_error("Out of IDCs while composing");
+                }
+            }
+            used_[static_cast<size_t>(next)] = true;
+            map_.emplace(key, next);
+            if (next != idc && !renumbered(group)) {
+                renumbered_groups_.push_back(group);
+            }
+            return next;
+        }
+
+        // Output IDC of a reference inside `group`, or `idc` if unmapped.
+        [[nodiscard]] int find(size_t group, int idc) const {
+            const auto found =
+                map_.find(RECORD_KEY(static_cast<int>(group), idc));
+            return found == map_.end() ? idc : found->second;
+        }
+
+        [[nodiscard]] bool renumbered(size_t group) const noexcept {
+            for (const size_t candidate : renumbered_groups_) {
+                if (candidate == group) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+      private:
+        std::unordered_map<uint64_t, int> map_;
+        std::vector<bool> used_ = std::vector<bool>(MAX_IDC + 1, false);
+        std::vector<size_t> renumbered_groups_;
+    };
+
+    // --------------------------------------------
+    // Record Rewriting (Text Only)
+    // --------------------------------------------
+    inline void APPEND_TEXT(std::vector<uint8_t>& out,
+                            const std::string& text) {
+        out.insert(out.end(), text.begin(), text.end());
+    }
+
+    inline std::string FORMAT_IDC(int idc) {
+        std::string text = std::to_string(idc);
+        return text.size() < 2U ? "0" + text : text;
+    }
+
+    // Writes `value` with the first item of each subfield passed through
+    // `remap`: the layout of ASC / SOR, whose first item is an IDC.
+    template <typename Remap>
+    inline void APPEND_REMAPPED_VALUE(std::vector<uint8_t>& out,
+                                      std::span<const uint8_t> value,
+                                      Remap&& remap) {
+        size_t position = 0U;
+        while (position <= value.size()) {
+            const size_t subfield_end = FIND_DELIMITER(value, position, RS, RS);
+            const auto subfield =
+                value.subspan(position, subfield_end - position);
+            const size_t item_end = FIND_DELIMITER(subfield, 0U, US, US);
+            size_t idc = 0U;
+            size_t copy_from = 0U;
+            if (PARSE_UNSIGNED(subfield.first(item_end), idc)) {
+                APPEND_TEXT(out, FORMAT_IDC(remap(static_cast<int>(idc))));
+                copy_from = item_end;
+            }
+            const auto rest = subfield.subspan(copy_from);
+            out.insert(out.end(), rest.begin(), rest.end());
+            if (subfield_end >= value.size()) {
+                break;
+            }
+            out.push_back(RS);
+            position = subfield_end + 1U;
+        }
+    }
+
+    // Re-emits a tagged record field by field: `rewrite(field, out)` returns
+    // true when it wrote the field's value itself. The .001 LEN is patched
+    // to the final size and a ".999" payload is referenced from the source
+    // rather than copied, so `out` receives only the text.
+    template <typename Rewrite>
+    inline void REWRITE_TAGGED_RECORD(std::span<const uint8_t> record,
+                                      SerializedSegments& out,
+                                      Rewrite&& rewrite) {
+        static constexpr uint8_t RECORD_END[] = {FS};
+
+        auto& text = out.owned.emplace_back();
+        size_t len_position = INVALID_INDEX;
+        std::span<const uint8_t> payload;
+
+        const PARSE_STATUS status =
+            FOR_EACH_TAGGED_FIELD(record, [&](const TaggedField& field) {
+                if (!text.empty()) {
+                    text.push_back(GS);
+                }
+                text.insert(text.end(), field.tag.begin(), field.tag.end());
+                text.push_back(':');
+
+                if (field.is_binary_field) {
+                    payload = field.value;
+                } else if (field.field_number == 1U && len_position ==
+                                                           INVALID_INDEX) {
+                    len_position = text.size();
+                } else if (!rewrite(field, text)) {
+                    text.insert(text.end(), field.value.begin(),
+                                field.value.end());
+                }
+                return true;
+            });
+        if (status != PARSE_OK || len_position == INVALID_INDEX) {
+            throw std::runtime_error(PARSE_STATUS_MESSAGE(
+                status != PARSE_OK ? status : PARSE_INVALID_TAGGED_LEN));
+        }
+
+        const std::string length = std::to_string(
+            SELF_COUNTING_LENGTH(text.size() + payload.size() + 1U));
+        text.insert(text.begin() + static_cast<long>(len_position),
+                    length.begin(), length.end());
+
+        if (payload.empty()) {
+            text.push_back(FS);
+            out.segments.emplace_back(text);
+            return;
+        }
+        out.segments.emplace_back(text);
+        out.segments.push_back(payload);
+        out.segments.emplace_back(RECORD_END);
+    }
+
+    // --------------------------------------------
+    // Transaction Composition
+    // --------------------------------------------
+    // Builds a transaction from the Type-1 record `type1` (its exact LEN
+    // span) and `records`, in order. IDCs are renumbered per IdcMap and IDC
+    // references (.995 ASC, .997 SOR) follow them. The Type-1 CNT and LEN
+    // are rewritten. Every other byte is referenced from the sources:
+    // records of untouched groups verbatim, renumbered binary records as a
+    // new 5-byte head plus the source tail, renumbered tagged records as new
+    // text plus the source ".999" payload. Sources must outlive the result.
+    inline SerializedSegments COMPOSE_TRANSACTION(
+        std::span<const uint8_t> type1,
+        const std::vector<SourceRecord>& records) {
+        // An IDC shared by any tagged record must stay two digits wide.
+        std::unordered_set<uint64_t> tagged;
+        for (const SourceRecord& record : records) {
+            if (!record.span.is_binary_record) {
+                tagged.insert(RECORD_KEY(static_cast<int>(record.group),
+                                         record.span.idc));
+            }
+        }
+
+        IdcMap idcs;
+        std::vector<int> new_idcs(records.size());
+        for (size_t i = 0; i < records.size(); i++) {
+            const SourceRecord& record = records[i];
+            const bool shares_tagged = tagged.contains(
+                RECORD_KEY(static_cast<int>(record.group), record.span.idc));
+            new_idcs[i] =
+                idcs.assign(record.group, record.span.idc,
+                            shares_tagged ? MAX_TAGGED_IDC : MAX_IDC);
+        }
+
+        SerializedSegments out;
+
+        // Type-1: copy every field but LEN and CNT.
+        REWRITE_TAGGED_RECORD(
+            type1, out,
+            [&](const TaggedField& field, std::vector<uint8_t>& text) {
+                if (field.field_number != CNT_FIELD) {
+                    return false;
+                }
+                APPEND_TEXT(text, "1");
+                text.push_back(US);
+                APPEND_TEXT(text, std::to_string(records.size()));
+                for (size_t i = 0; i < records.size(); i++) {
+                    text.push_back(RS);
+                    APPEND_TEXT(text, std::to_string(records[i].span.type));
+                    text.push_back(US);
+                    APPEND_TEXT(text, FORMAT_IDC(new_idcs[i]));
+                }
+                return true;
+            });
+
+        for (size_t i = 0; i < records.size(); i++) {
+            const SourceRecord& record = records[i];
+            const auto bytes =
+                record.source.subspan(record.span.offset, record.span.length);
+
+            if (!idcs.renumbered(record.group)) {
+                out.segments.push_back(bytes);
+                continue;
+            }
+
+            if (record.span.is_binary_record) {
+                auto& head = out.owned.emplace_back(
+                    bytes.begin(), bytes.begin() + BINARY_IDC_OFFSET + 1U);
+                head[BINARY_IDC_OFFSET] = static_cast<uint8_t>(new_idcs[i]);
+                out.segments.emplace_back(head);
+                out.segments.push_back(bytes.subspan(BINARY_IDC_OFFSET + 1U));
+                continue;
+            }
+
+            REWRITE_TAGGED_RECORD(
+                bytes, out,
+                [&](const TaggedField& field, std::vector<uint8_t>& text) {
+                    if (field.field_number == IDC_FIELD) {
+                        APPEND_TEXT(text, FORMAT_IDC(new_idcs[i]));
+                        return true;
+                    }
+                    if (field.field_number == ASC_FIELD ||
+                        field.field_number == SOR_FIELD) {
+                        APPEND_REMAPPED_VALUE(text, field.value, [&](int idc) {
+                            return idcs.find(record.group, idc);
+                        });
+                        return true;
+                    }
+                    return false;
+                });
+        }
+        return out;
+    }
+
+    // Appends the records of several transactions behind the Type-1 record
+    // of the first one, renumbering colliding IDCs per source.
+    inline SerializedSegments MERGE_TRANSACTIONS(
+        const std::vector<std::span<const uint8_t>>& transactions) {
+        if (transactions.empty()) {
+            throw std::runtime_error("Nothing to merge");
+        }
+
+        std::vector<SourceRecord> records;
+        std::span<const uint8_t> type1;
+        for (size_t t = 0; t < transactions.size(); t++) {
+            const RecordLocator locator(transactions[t]);
+            for (size_t r = 0; r < locator.size(); r++) {
+                if (r == 0U) {
+                    type1 = t == 0U ? locator.bytes(locator.at(0)) : type1;
+                    continue;
+                }
+                records.push_back({transactions[t], locator.at(r), t});
+            }
+        }
+        return COMPOSE_TRANSACTION(type1, records);
+    }
+
+    // Splits one transaction into several. Each group lists record ordinals
+    // (as in RecordLocator; 0, the Type-1 record, is implied) and becomes
+    // its own transaction with a copy of the Type-1 record and a new CNT.
+    inline std::vector<SerializedSegments> SPLIT_TRANSACTION(
+        std::span<const uint8_t> transaction,
+        const std::vector<std::vector<size_t>>& groups) {
+        const RecordLocator locator(transaction);
+        const auto type1 = locator.bytes(locator.at(0));
+
+        std::vector<SerializedSegments> parts;
+        parts.reserve(groups.size());
+        for (const auto& group : groups) {
+            std::vector<SourceRecord> records;
+            for (const size_t ordinal : group) {
+                if (ordinal != 0U) {
+                    records.push_back({transaction, locator.at(ordinal), 0U});
+                }
+            }
+            parts.push_back(COMPOSE_TRANSACTION(type1, records));
+        }
+        return parts;
+    }
+
+}  // namespace nnist
+#endif
@@ -1,6 +1,13 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+
+// Hosted-only APIs (exceptions, std::string, file IO) are compiled out when
+// the library is built with NNIST_FREESTANDING=1.
+#ifndef NNIST_FREESTANDING
+#define NNIST_FREESTANDING 0
+#endif
+
 namespace nnist {
     constexpr int RECORD_TYPE_1 = 1;
     constexpr int RECORD_TYPE_2 = 2;
@@ -14,7 +21,9 @@ namespace nnist {
     constexpr int RECORD_TYPE_10 = 10;
     constexpr int RECORD_TYPE_11 = 11;
     constexpr int RECORD_TYPE_12 = 12;
+    constexpr int RECORD_TYPE_13 = 13;
     constexpr int RECORD_TYPE_14 = 14;
+    constexpr int RECORD_TYPE_15 = 15;
     constexpr int RECORD_TYPE_17 = 17;
 
     constexpr uint32_t BYTE_MASK = 0xFFU;
@@ -31,6 +40,9 @@ namespace nnist {
     constexpr size_t TAGGED_LEN_WIDTH = 7U;
 
     constexpr uint32_t MIN_BINARY_RECORD_SIZE = 8U;
+    constexpr size_t BINARY_IDC_OFFSET = 4U;  // after the 4-byte LEN
+    constexpr size_t IDC_FIELD = 2U;          // <type>.002
+    constexpr size_t CNT_FIELD = 3U;          // 1.003
     constexpr size_t INVALID_INDEX = static_cast<size_t>(-1);
 
 }  // namespace nnist
@@ -0,0 +1,223 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "nnist/hash.h"
+#include "nnist/locator.h"
+#include "nnist/parallel.h"
+#include "nnist/parsers.h"
+#include "nnist/scan.h"
+
+namespace nnist {
+
+    // --------------------------------------------
+    // Record Fingerprints
+    // --------------------------------------------
+    struct RecordFingerprint {
+        RecordSpan span;
+        uint64_t hash = 0U;  // HASH_BYTES over the record's LEN span
+    };
+
+    // Locates records by LEN hops and hashes each one, in parallel. No
+    // record is tokenized.
+    inline std::vector<RecordFingerprint> FINGERPRINT_RECORDS(
+        std::span<const uint8_t> buffer, size_t thread_count = 0U) {
+        std::vector<RecordFingerprint> records;
+        size_t end_offset = 0U;
+        const PARSE_STATUS status = SCAN_RECORDS(
+            buffer, 0U,
+            [&](const RecordSpan& span) {
+                records.push_back({span, 0U});
+                return true;
+            },
+            end_offset);
+        if (status != PARSE_OK) {
+            throw std::runtime_error(PARSE_STATUS_MESSAGE(status));
+        }
+
+        PARALLEL_FOR(records.size(), thread_count, [&](size_t i) {
+            const auto& span = records[i].span;
+            records[i].hash =
+                HASH_BYTES(buffer.subspan(span.offset, span.length));
+        });
+        return records;
+    }
+
+    struct FieldFingerprint {
+        size_t field_number = 0U;
+        size_t offset = 0U;  // tag start, absolute
+        size_t length = 0U;  // tag through value, separators excluded
+        uint64_t hash = 0U;
+    };
+
+    inline std::vector<FieldFingerprint> FINGERPRINT_FIELDS(
+        std::span<const uint8_t> buffer, const RecordSpan& span) {
+        std::vector<FieldFingerprint> fields;
+        const auto record = buffer.subspan(span.offset, span.length);
+        FOR_EACH_TAGGED_FIELD(record, [&](const TaggedField& field) {
+            const size_t end = static_cast<size_t>(
+                field.value.data() + field.value.size() - record.data());
+            const auto bytes = record.subspan(field.offset, end - field.offset);
+            fields.push_back({field.field_number, span.offset + field.offset,
+                              bytes.size(), HASH_BYTES(bytes)});
+            return true;
+        });
+        return fields;
+    }
+
+    // --------------------------------------------
+    // Structural Diff
+    // --------------------------------------------
+    enum DIFF_KIND : uint8_t {
+        DIFF_RECORD_ADDED = 0,  // only in the right transaction
+        DIFF_RECORD_REMOVED,    // only in the left transaction
+        DIFF_RECORD_CHANGED,    // binary record bytes differ
+        DIFF_FIELD_ADDED,
+        DIFF_FIELD_REMOVED,
+        DIFF_FIELD_CHANGED
+    };
+
+    struct DiffEntry {
+        DIFF_KIND kind = DIFF_RECORD_CHANGED;
+        int type = -1;
+        int idc = -1;
+        size_t field_number = 0U;  // 0 for record-level entries
+        size_t left_offset = INVALID_INDEX;   // INVALID_INDEX when absent
+        size_t left_length = 0U;
+        size_t right_offset = INVALID_INDEX;
+        size_t right_length = 0U;
+    };
+
+    // Pairs the n-th occurrence of a key on the left with the n-th on the
+    // right, so repeated keys (e.g. two fields with one number) still line
+    // up. Calls fn(left index or INVALID_INDEX, right index or INVALID_INDEX)
+    // in left order, then for unmatched right entries.
+    template <typename Items, typename KeyFn, typename Fn>
+    inline void MATCH_BY_KEY(const Items& left, const Items& right,
+                             KeyFn&& key_of, Fn&& fn) {
+        std::unordered_map<uint64_t, std::vector<size_t>> right_index;
+        for (size_t i = right.size(); i-- > 0U;) {
+            right_index[key_of(right[i])].push_back(i);  // popped in order
+        }
+
+        std::vector<bool> matched(right.size(), false);
+        for (size_t i = 0; i < left.size(); i++) {
+            auto it = right_index.find(key_of(left[i]));
+            if (it == right_index.end() || it->second.empty()) {
+                fn(i, INVALID_INDEX);
+                continue;
+            }
+            const size_t j = it->second.back();
+            it->second.pop_back();
+            matched[j] = true;
+            fn(i, j);
+        }
+        for (size_t j = 0; j < right.size(); j++) {
+            if (!matched[j]) {
+                fn(INVALID_INDEX, j);
+            }
+        }
+    }
+
+    // Reports which records and fields differ between two transactions.
+    // Records are matched by (type, IDC) and compared by fingerprint; only
+    // records whose fingerprints differ are walked field by field, so the
+    // cost is one hashing pass plus the changed records.
+    inline std::vector<DiffEntry> DIFF_TRANSACTIONS(
+        std::span<const uint8_t> left, std::span<const uint8_t> right,
+        size_t thread_count = 0U) {
+        const auto left_records = FINGERPRINT_RECORDS(left, thread_count);
+        const auto right_records = FINGERPRINT_RECORDS(right, thread_count);
+        std::vector<DiffEntry> diff;
+
+        const auto record_key = [](const RecordFingerprint& record) {
+            return RECORD_KEY(record.span.type, record.span.idc);
+        };
+        MATCH_BY_KEY(
+            left_records, right_records, record_key, [&](size_t l, size_t r) {
+                const RecordFingerprint* a =
+                    l == INVALID_INDEX ? nullptr : &left_records[l];
+                const RecordFingerprint* b =
+                    r == INVALID_INDEX ? nullptr : &right_records[r];
+                const RecordSpan& span = a != nullptr ? a->span : b->span;
+
+                DiffEntry entry;
+                entry.type = span.type;
+                entry.idc = span.idc;
+                if (a != nullptr) {
+                    entry.left_offset = a->span.offset;
+                    entry.left_length = a->span.length;
+                }
+                if (b != nullptr) {
+                    entry.right_offset = b->span.offset;
+                    entry.right_length = b->span.length;
+                }
+
+                if (a == nullptr || b == nullptr) {
+                    entry.kind =
+                        a == nullptr ? DIFF_RECORD_ADDED : DIFF_RECORD_REMOVED;
+                    diff.push_back(entry);
+                    return;
+                }
+                if (a->hash == b->hash && a->span.length == b->span.length) {
+                    return;
+                }
+                if (span.is_binary_record || a->span.is_binary_record !=
+                                                 b->span.is_binary_record) {
+                    entry.kind = DIFF_RECORD_CHANGED;
+                    diff.push_back(entry);
+                    return;
+                }
+
+                const auto left_fields = FINGERPRINT_FIELDS(left, a->span);
+                const auto right_fields = FINGERPRINT_FIELDS(right, b->span);
+                MATCH_BY_KEY(
+                    left_fields, right_fields,
+                    [](const FieldFingerprint& field) {
+                        return static_cast<uint64_t>(field.field_number);
+                    },
+                    [&](size_t lf, size_t rf) {
+                        DiffEntry field_entry = entry;
+                        field_entry.left_offset = INVALID_INDEX;
+                        field_entry.left_length = 0U;
+                        field_entry.right_offset = INVALID_INDEX;
+                        field_entry.right_length = 0U;
+                        if (lf != INVALID_INDEX) {
+                            const auto& field = left_fields[lf];
+                            field_entry.field_number = field.field_number;
+                            field_entry.left_offset = field.offset;
+                            field_entry.left_length = field.length;
+                        }
+                        if (rf != INVALID_INDEX) {
+                            const auto& field = right_fields[rf];
+                            field_entry.field_number = field.field_number;
+                            field_entry.right_offset = field.offset;
+                            field_entry.right_length = field.length;
+                        }
+
+                        if (lf == INVALID_INDEX || rf == INVALID_INDEX) {
+                            field_entry.kind = lf == INVALID_INDEX
+                                                   ? DIFF_FIELD_ADDED
+                                                   : DIFF_FIELD_REMOVED;
+                        } else if (left_fields[lf].hash !=
+                                       right_fields[rf].hash ||
+                                   left_fields[lf].length !=
+                                       right_fields[rf].length) {
+                            field_entry.kind = DIFF_FIELD_CHANGED;
+                        } else {
+                            return;
+                        }
+                        diff.push_back(field_entry);
+                    });
+            });
+        return diff;
+    }
+
+}  // namespace nnist
+#endif
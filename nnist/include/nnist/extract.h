@@ -0,0 +1,287 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "nnist/mapped_file.h"
+#include "nnist/parsers.h"
+#include "nnist/scan.h"
+#include "nnist/serdes.h"
+#include "nnist/types.h"
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+#endif
+
+namespace nnist {
+
+    constexpr size_t BINARY_IMAGE_HEADER_SIZE = 18U;      // Types 3-7
+    constexpr size_t SIGNATURE_IMAGE_HEADER_SIZE = 12U;   // Type 8
+    constexpr size_t BINARY_FGP_OFFSET = 6U;              // first FGP byte
+    constexpr uint8_t BINARY_FGP_UNUSED = 0xFFU;
+    constexpr size_t TAGGED_FGP_FIELD = 13U;  // 13.013 / 14.013 / 15.013
+    constexpr size_t COPY_CHUNK_SIZE = size_t{1} << 20U;
+
+    // --------------------------------------------
+    // Image Payload Location
+    // --------------------------------------------
+    struct ImagePayload {
+        int type = -1;
+        int idc = -1;
+        int finger_position = -1;  // -1 when the record carries none
+        size_t offset = 0U;        // first image byte in the source buffer
+        size_t length = 0U;
+    };
+
+    inline bool HAS_TAGGED_FGP(int record_type) noexcept {
+        return record_type == RECORD_TYPE_13 ||
+               record_type == RECORD_TYPE_14 || record_type == RECORD_TYPE_15;
+    }
+
+    // Finds every image payload of one transaction by LEN hops: the fixed
+    // binary header for Types 3-8 and the ".999" field for tagged records.
+    // Only headers and tagged text are read; image bytes are not touched.
+    inline std::vector<ImagePayload> LOCATE_IMAGES(
+        std::span<const uint8_t> buffer) {
+        std::vector<ImagePayload> images;
+        size_t end_offset = 0U;
+
+        const PARSE_STATUS status = SCAN_RECORDS(
+            buffer, 0U,
+            [&](const RecordSpan& span) {
+                const auto record = buffer.subspan(span.offset, span.length);
+                ImagePayload image;
+                image.type = span.type;
+                image.idc = span.idc;
+
+                if (span.is_binary_record) {
+                    const size_t header = span.type == RECORD_TYPE_8
+                                              ? SIGNATURE_IMAGE_HEADER_SIZE
+                                              : BINARY_IMAGE_HEADER_SIZE;
+                    if (record.size() <= header) {
+                        return true;
+                    }
+                    // Type-7 is user-defined; only Types 3-6 fix the FGP.
+                    if (span.type < RECORD_TYPE_7 &&
+                        record[BINARY_FGP_OFFSET] != BINARY_FGP_UNUSED) {
+                        image.finger_position = record[BINARY_FGP_OFFSET];
+                    }
+                    image.offset = span.offset + header;
+                    image.length = record.size() - header;
+                    images.push_back(image);
+                    return true;
+                }
+
+                FOR_EACH_TAGGED_FIELD(record, [&](const TaggedField& field) {
+                    size_t position = 0U;
+                    if (field.field_number == TAGGED_FGP_FIELD &&
+                        HAS_TAGGED_FGP(span.type) &&
+                        PARSE_UNSIGNED(field.value, position)) {
+                        image.finger_position = static_cast<int>(position);
+                    }
+                    if (field.is_binary_field && !field.value.empty()) {
+                        image.offset = span.offset +
+                                       static_cast<size_t>(
+                                           field.value.data() - record.data());
+                        image.length = field.value.size();
+                        images.push_back(image);
+                    }
+                    return true;
+                });
+                return true;
+            },
+            end_offset);
+
+        if (status != PARSE_OK) {
+            throw std::runtime_error(PARSE_STATUS_MESSAGE(status));
+        }
+        return images;
+    }
+
+    // File extension from the payload's leading bytes.
+    inline const char* IMAGE_EXTENSION(
+        std::span<const uint8_t> payload) noexcept {
+        constexpr uint8_t MARKER = 0xFFU;
+        constexpr uint8_t JPEG_SOI = 0xD8U;
+        constexpr uint8_t WSQ_SOI = 0xA0U;
+        constexpr uint8_t PNG_SIGNATURE = 0x89U;
+        constexpr uint8_t JP2_BOX_SIZE = 0x0CU;
+        constexpr size_t JP2_BRAND = 4U;
+
+        if (payload.size() >= 2U && payload[0] == MARKER) {
+            if (payload[1] == JPEG_SOI) {
+                return "jpg";
+            }
+            if (payload[1] == WSQ_SOI) {
+                return "wsq";
+            }
+        }
+        if (payload.size() >= 4U && payload[0] == PNG_SIGNATURE &&
+            payload[1] == 'P' && payload[2] == 'N' && payload[3] == 'G') {
+            return "png";
+        }
+        if (payload.size() >= JP2_BRAND + 2U && payload[0] == 0U &&
+            payload[1] == 0U && payload[2] == 0U &&
+            payload[3] == JP2_BOX_SIZE && payload[JP2_BRAND] == 'j' &&
+            payload[JP2_BRAND + 1U] == 'P') {
+            return "jp2";
+        }
+        return "raw";
+    }
+
+    // "<prefix>type14_idc04_fgp01.wsq"; the FGP part is omitted when the
+    // record carries no finger position.
+    inline std::string IMAGE_FILE_NAME(const ImagePayload& image,
+                                       const char* extension,
+                                       const std::string& prefix = {}) {
+        char name[64];
+        if (image.finger_position >= 0) {
+            std::snprintf(name, sizeof(name), "type%d_idc%02d_fgp%02d.%s",
+                          image.type, image.idc, image.finger_position,
+                          extension);
+        } else {
+            std::snprintf(name, sizeof(name), "type%d_idc%02d.%s", image.type,
+                          image.idc, extension);
+        }
+        return prefix + name;
+    }
+
+    // --------------------------------------------
+    // Kernel-Side Copy
+    // --------------------------------------------
+#if !defined(_WIN32)
+    // Copies [offset, offset + length) of `input` to the current position
+    // of `output` without passing the bytes through user space where the
+    // platform allows it: copy_file_range, then sendfile, then a bounded
+    // pread/write loop for descriptors neither supports.
+    inline void COPY_FILE_RANGE(int input, size_t offset, size_t length,
+                                int output) {
+        auto source = static_cast<off_t>(offset);
+        size_t remaining = length;
+
+#if defined(__linux__)
+        while (remaining > 0U) {
+            const ssize_t copied = ::copy_file_range(input, &source, output,
+                                                     nullptr, remaining, 0U);
+            if (copied <= 0) {
+                if (copied < 0 && errno == EINTR) {
+                    continue;
+                }
+                break;  // EXDEV, ENOSYS, EINVAL...: try sendfile
+            }
+            remaining -= static_cast<size_t>(copied);
+        }
+        while (remaining > 0U) {
+            const ssize_t sent =
+                ::sendfile(output, input, &source, remaining);
+            if (sent <= 0) {
+                if (sent < 0 && errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            remaining -= static_cast<size_t>(sent);
+        }
+#endif
+
+        std::vector<uint8_t> chunk;
+        while (remaining > 0U) {
+            chunk.resize(std::min(remaining, COPY_CHUNK_SIZE));
+            const ssize_t got =
+                ::pread(input, chunk.data(), chunk.size(), source);
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got <= 0) {
+                throw std::runtime_error("Failed to read image payload");
+            }
+            size_t written = 0U;
+            while (written < static_cast<size_t>(got)) {
+                const ssize_t put =
+                    ::write(output, chunk.data() + written,
+                            static_cast<size_t>(got) - written);
+                if (put < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (put <= 0) {
+                    throw std::runtime_error("Failed to write image payload");
+                }
+                written += static_cast<size_t>(put);
+            }
+            source += static_cast<off_t>(got);
+            remaining -= static_cast<size_t>(got);
+        }
+    }
+#endif
+
+    // --------------------------------------------
+    // Bulk Extraction
+    // --------------------------------------------
+    struct ExtractedImage {
+        ImagePayload payload;
+        std::filesystem::path path;
+    };
+
+    // Writes every image payload of the transaction at `input` to its own
+    // file in `output_dir`, named by IMAGE_FILE_NAME with the input stem as
+    // prefix. The source is mapped only to read headers and to sniff each
+    // payload's first bytes; the payload itself is moved by the kernel.
+    inline std::vector<ExtractedImage> EXTRACT_IMAGES(
+        const std::filesystem::path& input,
+        const std::filesystem::path& output_dir) {
+        const MappedFile source(input);
+        const auto images = LOCATE_IMAGES(source.bytes());
+        const std::string prefix = input.stem().string() + "_";
+
+        std::filesystem::create_directories(output_dir);
+        std::vector<ExtractedImage> extracted;
+        extracted.reserve(images.size());
+
+        for (const auto& image : images) {
+            const auto payload =
+                source.bytes().subspan(image.offset, image.length);
+            ExtractedImage out{image,
+                               output_dir /
+                                   IMAGE_FILE_NAME(image,
+                                                   IMAGE_EXTENSION(payload),
+                                                   prefix)};
+#if defined(_WIN32)
+            WRITE_FILE(out.path,
+                       std::vector<uint8_t>(payload.begin(), payload.end()));
+#else
+            const int output = ::open(
+                out.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+            if (output < 0) {
+                throw std::runtime_error("Failed to open file: " +
+                                         out.path.string());
+            }
+            try {
+                COPY_FILE_RANGE(source.descriptor(), image.offset,
+                                image.length, output);
+            } catch (...) {
+                ::close(output);
+                throw;
+            }
+            ::close(output);
+#endif
+            extracted.push_back(std::move(out));
+        }
+        return extracted;
+    }
+
+}  // namespace nnist
+#endif
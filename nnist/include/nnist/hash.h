@@ -0,0 +1,116 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "nnist/constants.h"
+
+namespace nnist {
+
+    // --------------------------------------------
+    // Content Hash (XXH64)
+    // --------------------------------------------
+    // 64-bit XXH64 over a byte range: four independent lanes per 32-byte
+    // stripe, so long image payloads hash at memory speed. Allocation-free
+    // and portable; used for record fingerprints and cache keys.
+    constexpr uint64_t HASH_PRIME_1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t HASH_PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t HASH_PRIME_3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t HASH_PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t HASH_PRIME_5 = 0x27D4EB2F165667C5ULL;
+    constexpr size_t HASH_STRIPE = 32U;
+
+    constexpr uint64_t HASH_ROTL(uint64_t value, uint32_t bits) noexcept {
+        return (value << bits) | (value >> (64U - bits));
+    }
+
+    inline uint64_t HASH_READ_U64(const uint8_t* bytes) noexcept {
+        uint64_t value = 0U;
+        std::memcpy(&value, bytes, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        value = __builtin_bswap64(value);
+#endif
+        return value;
+    }
+
+    inline uint32_t HASH_READ_U32(const uint8_t* bytes) noexcept {
+        uint32_t value = 0U;
+        std::memcpy(&value, bytes, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        value = __builtin_bswap32(value);
+#endif
+        return value;
+    }
+
+    constexpr uint64_t HASH_ROUND(uint64_t lane, uint64_t input) noexcept {
+        constexpr uint32_t ROUND_ROTATION = 31U;
+        return HASH_ROTL(lane + input * HASH_PRIME_2, ROUND_ROTATION) *
+               HASH_PRIME_1;
+    }
+
+    constexpr uint64_t HASH_MERGE(uint64_t hash, uint64_t lane) noexcept {
+        return (hash ^ HASH_ROUND(0U, lane)) * HASH_PRIME_1 + HASH_PRIME_4;
+    }
+
+    inline uint64_t HASH_BYTES(std::span<const uint8_t> bytes,
+                               uint64_t seed = 0U) noexcept {
+        constexpr uint32_t LANE_ROTATIONS[] = {1U, 7U, 12U, 18U};
+        constexpr uint32_t WORD_ROTATION = 27U;
+        constexpr uint32_t HALF_ROTATION = 23U;
+        constexpr uint32_t BYTE_ROTATION = 11U;
+        constexpr uint32_t AVALANCHE_SHIFT_1 = 33U;
+        constexpr uint32_t AVALANCHE_SHIFT_2 = 29U;
+        constexpr uint32_t AVALANCHE_SHIFT_3 = 32U;
+
+        const uint8_t* data = bytes.data();
+        const uint8_t* const end = data + bytes.size();
+        uint64_t hash = 0U;
+
+        if (bytes.size() >= HASH_STRIPE) {
+            uint64_t lanes[4] = {seed + HASH_PRIME_1 + HASH_PRIME_2,
+                                 seed + HASH_PRIME_2, seed,
+                                 seed - HASH_PRIME_1};
+            while (end - data >= static_cast<ptrdiff_t>(HASH_STRIPE)) {
+                for (size_t lane = 0; lane < 4U; lane++) {
+                    lanes[lane] = HASH_ROUND(
+                        lanes[lane], HASH_READ_U64(data + lane * 8U));
+                }
+                data += HASH_STRIPE;
+            }
+            for (size_t lane = 0; lane < 4U; lane++) {
+                hash += HASH_ROTL(lanes[lane], LANE_ROTATIONS[lane]);
+            }
+            for (const uint64_t lane : lanes) {
+                hash = HASH_MERGE(hash, lane);
+            }
+        } else {
+            hash = seed + HASH_PRIME_5;
+        }
+
+        hash += static_cast<uint64_t>(bytes.size());
+
+        while (end - data >= 8) {
+            hash ^= HASH_ROUND(0U, HASH_READ_U64(data));
+            hash = HASH_ROTL(hash, WORD_ROTATION) * HASH_PRIME_1 + HASH_PRIME_4;
+            data += 8;
+        }
+        if (end - data >= 4) {
+            hash ^= static_cast<uint64_t>(HASH_READ_U32(data)) * HASH_PRIME_1;
+            hash = HASH_ROTL(hash, HALF_ROTATION) * HASH_PRIME_2 + HASH_PRIME_3;
+            data += 4;
+        }
+        while (data < end) {
+            hash ^= static_cast<uint64_t>(*data) * HASH_PRIME_5;
+            hash = HASH_ROTL(hash, BYTE_ROTATION) * HASH_PRIME_1;
+            ++data;
+        }
+
+        hash ^= hash >> AVALANCHE_SHIFT_1;
+        hash *= HASH_PRIME_2;
+        hash ^= hash >> AVALANCHE_SHIFT_2;
+        hash *= HASH_PRIME_3;
+        hash ^= hash >> AVALANCHE_SHIFT_3;
+        return hash;
+    }
+
+}  // namespace nnist
@@ -0,0 +1,139 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nnist/parsers.h"
+#include "nnist/scan.h"
+#include "nnist/types.h"
+
+namespace nnist {
+
+    constexpr size_t TYPE1_PREFIX_BLOCK = 4096U;
+
+    // --------------------------------------------
+    // Type-1 Header (Bounded Prefix Read)
+    // --------------------------------------------
+    struct Type1Header {
+        Record record;
+        Type1Fields fields;  // header field positions within record.fields
+        std::vector<std::pair<int, int>> plan;  // CNT [type, IDC] entries
+        size_t bytes_read = 0U;
+        // The prefix READ_TYPE1_HEADER read; record's source span indexes
+        // it, and copies of the header share it. Null when the caller of
+        // PARSE_TYPE1_HEADER_INTO owns the prefix.
+        std::shared_ptr<const std::vector<uint8_t>> source;
+
+        // Field "1.<number>" (either tag width); nullptr when absent.
+        [[nodiscard]] const Field* field(size_t number) const noexcept {
+            if (Type1Fields::member(number) != nullptr) {
+                const size_t index = fields.at(number);
+                return index == INVALID_INDEX ? nullptr
+                                              : &record.fields[index];
+            }
+            for (const auto& candidate : record.fields) {
+                int record_type = -1;
+                size_t field_number = 0U;
+                if (PARSE_FIELD_TAG(candidate.tag, record_type,
+                                    field_number) &&
+                    field_number == number) {
+                    return &candidate;
+                }
+            }
+            return nullptr;
+        }
+
+        // First item of a single-valued field, or "" when absent.
+        [[nodiscard]] std::string text(size_t number) const {
+            const Field* found = field(number);
+            if (found == nullptr || found->subfields.empty() ||
+                found->subfields[0].items.empty()) {
+                return {};
+            }
+            const auto& bytes = found->subfields[0].items[0].bytes;
+            return {bytes.begin(), bytes.end()};
+        }
+    };
+
+    // Parses the Type-1 record from the front of `prefix`, which must hold
+    // at least the declared 1.001 LEN bytes.
+    inline PARSE_STATUS PARSE_TYPE1_HEADER_INTO(
+        std::span<const uint8_t> prefix, Type1Header& header) {
+        int record_type = -1;
+        size_t length = 0U;
+        if (!READ_TAGGED_HEADER(prefix, 0U, record_type, length) ||
+            record_type != RECORD_TYPE_1) {
+            return PARSE_INVALID_TAGGED_LEN;
+        }
+        if (length > prefix.size()) {
+            return PARSE_TRUNCATED;
+        }
+
+        Cursor cursor{prefix.first(length)};
+        const PARSE_STATUS status = RecordParser<RECORD_TYPE_1>::parse(
+            cursor, header.record, header.fields);
+        if (status != PARSE_OK) {
+            return status;
+        }
+        header.record.type = RECORD_TYPE_1;
+        header.record.idc = -1;
+        SET_SOURCE_SPAN(header.record, prefix, 0U, length);
+        header.plan = PARSE_CNT_PLAN(header.record);
+        return PARSE_OK;
+    }
+
+    // Reads only the Type-1 record of a transaction file: one block first,
+    // then exactly the remainder of the 1.001 LEN if the record is longer.
+    // The rest of the file is never read.
+    inline Type1Header READ_TYPE1_HEADER(
+        const std::filesystem::path& path,
+        size_t initial_block = TYPE1_PREFIX_BLOCK) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to open file: " + path.string());
+        }
+
+        const auto read_more = [&](std::vector<uint8_t>& prefix,
+                                   size_t target) {
+            const size_t start = prefix.size();
+            prefix.resize(target);
+            file.read(reinterpret_cast<char*>(prefix.data() + start),
+                      static_cast<std::streamsize>(target - start));
+            prefix.resize(start + static_cast<size_t>(file.gcount()));
+        };
+
+        std::vector<uint8_t> prefix;
+        read_more(prefix, initial_block < MAX_TAGGED_HEADER_WIDTH
+                              ? MAX_TAGGED_HEADER_WIDTH
+                              : initial_block);
+
+        int record_type = -1;
+        size_t length = 0U;
+        if (READ_TAGGED_HEADER(prefix, 0U, record_type, length) &&
+            length > prefix.size() && file) {
+            read_more(prefix, length);
+        }
+
+        auto bytes =
+            std::make_shared<const std::vector<uint8_t>>(std::move(prefix));
+        Type1Header header;
+        header.bytes_read = bytes->size();
+        const PARSE_STATUS status = PARSE_TYPE1_HEADER_INTO(*bytes, header);
+        if (status != PARSE_OK) {
+            throw std::runtime_error(PARSE_STATUS_MESSAGE(status));
+        }
+        header.source = std::move(bytes);
+        return header;
+    }
+
+}  // namespace nnist
+#endif
@@ -0,0 +1,839 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING && defined(__linux__)
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "nnist/integrity.h"
+#include "nnist/parallel.h"
+#include "nnist/parsers.h"
+#include "nnist/types.h"
+
+namespace nnist {
+
+    // Wire format: each request is a 4-byte big-endian payload length and
+    // one transaction; each reply is INGEST_REPLY_SIZE bytes (see
+    // WRITE_INGEST_REPLY), sent in completion order and matched to its
+    // request by the per-connection sequence number.
+    constexpr size_t INGEST_FRAME_HEADER = 4U;
+    constexpr size_t INGEST_REPLY_SIZE = 12U;
+    constexpr size_t DEFAULT_INGEST_MAX_FRAME = size_t{64} << 20U;
+    constexpr size_t DEFAULT_INGEST_QUEUE = 256U;
+    constexpr size_t INGEST_READ_CHUNK = size_t{64} << 10U;
+    constexpr int INGEST_MAX_EVENTS = 64;
+    constexpr int INGEST_LISTEN_BACKLOG = 128;
+
+    enum INGEST_STATUS : uint8_t {
+        INGEST_ACCEPTED = 0,
+        INGEST_INTEGRITY_FAILED,  // detail is the INTEGRITY_ERROR
+        INGEST_PARSE_FAILED,      // detail is the PARSE_STATUS
+        INGEST_FRAME_TOO_LARGE    // the connection is closed after it
+    };
+
+    struct IngestReply {
+        uint32_t sequence = 0U;  // 0-based request index on the connection
+        uint32_t records = 0U;   // parsed records, Type-1 included
+        INGEST_STATUS status = INGEST_ACCEPTED;
+        uint8_t detail = 0U;
+    };
+
+    inline void WRITE_BE_U32(uint8_t* out, uint32_t value) noexcept {
+        out[BYTE_INDEX_0] = static_cast<uint8_t>(value >> SHIFT_24);
+        out[BYTE_INDEX_1] = static_cast<uint8_t>(value >> SHIFT_16);
+        out[BYTE_INDEX_2] = static_cast<uint8_t>(value >> SHIFT_8);
+        out[BYTE_INDEX_3] = static_cast<uint8_t>(value);
+    }
+
+    // [sequence u32][records u32][status u8][detail u8][2 reserved bytes]
+    inline void WRITE_INGEST_REPLY(const IngestReply& reply,
+                                   uint8_t* out) noexcept {
+        constexpr size_t RECORDS_OFFSET = 4U;
+        constexpr size_t STATUS_OFFSET = 8U;
+        WRITE_BE_U32(out, reply.sequence);
+        WRITE_BE_U32(out + RECORDS_OFFSET, reply.records);
+        out[STATUS_OFFSET] = reply.status;
+        out[STATUS_OFFSET + 1U] = reply.detail;
+        out[STATUS_OFFSET + 2U] = 0U;
+        out[STATUS_OFFSET + 3U] = 0U;
+    }
+
+    inline IngestReply READ_INGEST_REPLY(const uint8_t* bytes) noexcept {
+        constexpr size_t RECORDS_OFFSET = 4U;
+        constexpr size_t STATUS_OFFSET = 8U;
+        IngestReply reply;
+        reply.sequence = READ_BE_U32(bytes);
+        reply.records = READ_BE_U32(bytes + RECORDS_OFFSET);
+        reply.status = static_cast<INGEST_STATUS>(bytes[STATUS_OFFSET]);
+        reply.detail = bytes[STATUS_OFFSET + 1U];
+        return reply;
+    }
+
+    // Default request handler: the allocation-free integrity scan first, so
+    // malformed input is rejected before any tree is built, then a full
+    // parse.
+    inline IngestReply INGEST_TRANSACTION(std::span<const uint8_t> frame) {
+        IngestReply reply;
+        const IntegrityError error = FIRST_INTEGRITY_ERROR(frame);
+        if (error.error != INTEGRITY_OK) {
+            reply.status = INGEST_INTEGRITY_FAILED;
+            reply.detail = error.error;
+            return reply;
+        }
+
+        File file;
+        const PARSE_STATUS status = PARSE_FILE_INTO(frame, file);
+        if (status != PARSE_OK) {
+            reply.status = INGEST_PARSE_FAILED;
+            reply.detail = status;
+            return reply;
+        }
+        reply.records = static_cast<uint32_t>(file.records.size());
+        return reply;
+    }
+
+    // --------------------------------------------
+    // Latency Histogram
+    // --------------------------------------------
+    // Log-linear buckets: values below 8 are exact, above that each power
+    // of two is split in 8, so a percentile is within 12.5% of the true
+    // value. Recording is one relaxed atomic increment.
+    class LatencyHistogram {
+      public:
+        static constexpr uint32_t SUB_BUCKET_BITS = 3U;
+        static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+        static constexpr size_t BUCKETS = 64U * SUB_BUCKETS;
+
+        void record(uint64_t value) noexcept {
+            counts_[BUCKET_OF(value)].fetch_add(1U, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] uint64_t count() const noexcept {
+            uint64_t total = 0U;
+            for (const auto& bucket : counts_) {
+                total += bucket.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        // Upper bound of the bucket holding the `fraction` quantile (0.99
+        // for p99), or 0 when nothing was recorded.
+        [[nodiscard]] uint64_t percentile(double fraction) const noexcept {
+            const uint64_t total = count();
+            if (total == 0U) {
+                return 0U;
+            }
+            auto rank = static_cast<uint64_t>(
+                fraction * static_cast<double>(total) + 0.5);
+            rank = std::clamp<uint64_t>(rank, 1U, total);
+
+            uint64_t seen = 0U;
+            for (size_t bucket = 0; bucket < BUCKETS; bucket++) {
+                seen += counts_[bucket].load(std::memory_order_relaxed);
+                if (seen >= rank) {
+                    return BUCKET_LIMIT(bucket);
+                }
+            }
+            return BUCKET_LIMIT(BUCKETS - 1U);
+        }
+
+        static size_t BUCKET_OF(uint64_t value) noexcept {
+            if (value < SUB_BUCKETS) {
+                return static_cast<size_t>(value);
+            }
+            const auto magnitude =
+                static_cast<uint32_t>(63 - std::countl_zero(value));
+            const uint64_t sub =
+                (value >> (magnitude - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1U);
+            return (magnitude - SUB_BUCKET_BITS + 1U) * SUB_BUCKETS +
+                   static_cast<size_t>(sub);
+        }
+
+        // Largest value that lands in `bucket`.
+        static uint64_t BUCKET_LIMIT(size_t bucket) noexcept {
+            if (bucket < SUB_BUCKETS) {
+                return bucket;
+            }
+            const auto shift =
+                static_cast<uint32_t>(bucket / SUB_BUCKETS - 1U);
+            const uint64_t lower = (SUB_BUCKETS + bucket % SUB_BUCKETS)
+                                   << shift;
+            return lower + (uint64_t{1} << shift) - 1U;
+        }
+
+      private:
+        std::array<std::atomic<uint64_t>, BUCKETS> counts_{};
+    };
+
+    // --------------------------------------------
+    // Ingest Server (epoll + Worker Pool)
+    // --------------------------------------------
+    struct IngestOptions {
+        std::string unix_path;     // listen here when set...
+        uint16_t tcp_port = 0U;    // ...else on 127.0.0.1 (0 = any free port)
+        size_t worker_count = 0U;  // 0 = hardware concurrency
+        size_t queue_capacity = DEFAULT_INGEST_QUEUE;
+        size_t max_frame = DEFAULT_INGEST_MAX_FRAME;
+    };
+
+    struct IngestStats {
+        uint64_t connections = 0U;  // accepted since start
+        uint64_t frames = 0U;       // complete requests received
+        uint64_t bytes = 0U;        // request payload bytes
+        uint64_t accepted = 0U;     // INGEST_ACCEPTED replies
+        uint64_t rejected = 0U;     // every other reply
+        uint64_t pauses = 0U;       // reads paused on a full queue
+    };
+
+    using IngestHandler = std::function<IngestReply(std::span<const uint8_t>)>;
+
+    // Receives length-framed transactions on a Unix domain socket or
+    // localhost TCP. One thread runs a level-triggered epoll loop over
+    // non-blocking sockets and only moves bytes; `worker_count` threads run
+    // the handler. The job queue is bounded: when it is full the loop stops
+    // reading from that connection (its socket buffer then fills and the
+    // client blocks) and resumes as workers drain the queue. Each
+    // connection buffers at most max_frame plus a frame header. Latency is
+    // measured per request from the last byte received to the reply being
+    // ready, time spent paused included, in nanoseconds.
+    class IngestServer {
+      public:
+        explicit IngestServer(IngestOptions options,
+                              IngestHandler handler = INGEST_TRANSACTION)
+            : options_(std::move(options)), handler_(std::move(handler)) {
+            if (options_.queue_capacity == 0U) {
+                options_.queue_capacity = 1U;
+            }
+            open_listener();
+            epoll_ = ::epoll_create1(EPOLL_CLOEXEC);
+            wake_ = ::eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (epoll_ < 0 || wake_ < 0) {
+                close_all();
+                throw std::runtime_error("Failed to create epoll instance");
+            }
+            watch(listener_, LISTENER_ID, EPOLLIN, EPOLL_CTL_ADD);
+            watch(wake_, WAKE_ID, EPOLLIN, EPOLL_CTL_ADD);
+
+            const size_t workers = options_.worker_count == 0U
+                                       ? DEFAULT_THREAD_COUNT()
+                                       : options_.worker_count;
+            for (size_t i = 0; i < workers; i++) {
+                workers_.emplace_back([this]() { work(); });
+            }
+            loop_ = std::thread([this]() { run(); });
+        }
+
+        ~IngestServer() { stop(); }
+
+        IngestServer(const IngestServer&) = delete;
+        IngestServer& operator=(const IngestServer&) = delete;
+
+        // Stops accepting, drops open connections and joins every thread.
+        void stop() {
+            if (stopping_.exchange(true)) {
+                return;
+            }
+            signal_loop();
+            loop_.join();
+            {
+                const std::lock_guard<std::mutex> lock(jobs_mutex_);
+                jobs_.clear();
+            }
+            jobs_changed_.notify_all();
+            for (auto& worker : workers_) {
+                worker.join();
+            }
+            for (auto& [id, connection] : connections_) {
+                ::close(connection.fd);
+            }
+            connections_.clear();
+            close_all();
+        }
+
+        // Bound TCP port (useful with tcp_port = 0); 0 for Unix sockets.
+        [[nodiscard]] uint16_t port() const noexcept { return port_; }
+
+        [[nodiscard]] IngestStats stats() const noexcept {
+            IngestStats stats;
+            stats.connections = connections_accepted_.load(RELAXED);
+            stats.frames = frames_.load(RELAXED);
+            stats.bytes = bytes_.load(RELAXED);
+            stats.accepted = accepted_.load(RELAXED);
+            stats.rejected = rejected_.load(RELAXED);
+            stats.pauses = pauses_.load(RELAXED);
+            return stats;
+        }
+
+        [[nodiscard]] const LatencyHistogram& latency() const noexcept {
+            return latency_;
+        }
+
+      private:
+        static constexpr std::memory_order RELAXED = std::memory_order_relaxed;
+        static constexpr uint64_t LISTENER_ID = 0U;
+        static constexpr uint64_t WAKE_ID = 1U;
+        using Clock = std::chrono::steady_clock;
+
+        struct Connection {
+            int fd = -1;
+            std::vector<uint8_t> in;  // received bytes are [in_start, in_end)
+            size_t in_start = 0U;
+            size_t in_end = 0U;
+            std::vector<uint8_t> out;
+            size_t out_sent = 0U;
+            Clock::time_point received;  // when the last read returned data
+            uint32_t next_sequence = 0U;
+            size_t in_flight = 0U;
+            bool paused = false;     // queue full; EPOLLIN off
+            bool read_done = false;  // peer shut down or frame too large
+        };
+
+        struct Job {
+            uint64_t connection = 0U;
+            uint32_t sequence = 0U;
+            std::vector<uint8_t> frame;
+            Clock::time_point received;
+        };
+
+        struct Completion {
+            uint64_t connection = 0U;
+            IngestReply reply;
+        };
+
+        void open_listener() {
+            if (!options_.unix_path.empty()) {
+                sockaddr_un address{};
+                if (options_.unix_path.size() >= sizeof(address.sun_path)) {
+                    throw std::runtime_error("Socket path too long: " +
+                                             options_.unix_path);
+                }
+                address.sun_family = AF_UNIX;
+                std::copy(options_.unix_path.begin(),
+                          options_.unix_path.end(), address.sun_path);
+                ::unlink(options_.unix_path.c_str());
+                listener_ = ::socket(AF_UNIX,
+                                     SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                                     0);
+                if (listener_ < 0 ||
+                    ::bind(listener_, reinterpret_cast<sockaddr*>(&address),
+                           sizeof(address)) != 0) {
+                    close_all();
+                    throw std::runtime_error("Failed to bind " +
+                                             options_.unix_path);
+                }
+            } else {
+                sockaddr_in address{};
+                address.sin_family = AF_INET;
+                address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                address.sin_port = htons(options_.tcp_port);
+                listener_ = ::socket(AF_INET,
+                                     SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                                     0);
+                const int reuse = 1;
+                if (listener_ < 0 ||
+                    ::setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &reuse,
+                                 sizeof(reuse)) != 0 ||
+                    ::bind(listener_, reinterpret_cast<sockaddr*>(&address),
+                           sizeof(address)) != 0) {
+                    close_all();
+                    throw std::runtime_error("Failed to bind 127.0.0.1:" +
+                                             std::to_string(options_.tcp_port));
+                }
+                socklen_t length = sizeof(address);
+                ::getsockname(listener_, reinterpret_cast<sockaddr*>(&address),
+                              &length);
+                port_ = ntohs(address.sin_port);
+            }
+            if (::listen(listener_, INGEST_LISTEN_BACKLOG) != 0) {
+                close_all();
+                throw std::runtime_error("Failed to listen");
+            }
+        }
+
+        void close_all() noexcept {
+            for (int* fd : {&listener_, &epoll_, &wake_}) {
+                if (*fd >= 0) {
+                    ::close(*fd);
+                    *fd = -1;
+                }
+            }
+            if (!options_.unix_path.empty()) {
+                ::unlink(options_.unix_path.c_str());
+            }
+        }
+
+        void watch(int fd, uint64_t id, uint32_t events, int operation) {
+            epoll_event event{};
+            event.events = events;
+            event.data.u64 = id;
+            ::epoll_ctl(epoll_, operation, fd, &event);
+        }
+
+        void signal_loop() noexcept {
+            const uint64_t one = 1U;
+            [[maybe_unused]] const ssize_t written =
+                ::write(wake_, &one, sizeof(one));
+        }
+
+        // ---- Event loop thread ----
+        void run() {
+            std::array<epoll_event, INGEST_MAX_EVENTS> events{};
+            while (!stopping_.load(RELAXED)) {
+                const int ready =
+                    ::epoll_wait(epoll_, events.data(), INGEST_MAX_EVENTS, -1);
+                if (ready < 0 && errno != EINTR) {
+                    break;
+                }
+                for (int i = 0; i < ready; i++) {
+                    const epoll_event& event =
+                        events[static_cast<size_t>(i)];
+                    if (event.data.u64 == LISTENER_ID) {
+                        accept_connections();
+                    } else if (event.data.u64 == WAKE_ID) {
+                        deliver_completions();
+                    } else {
+                        service(event.data.u64, event.events);
+                    }
+                }
+            }
+        }
+
+        void accept_connections() {
+            while (true) {
+                const int fd = ::accept4(listener_, nullptr, nullptr,
+                                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0) {
+                    return;  // EAGAIN, or an aborted connection
+                }
+                if (options_.unix_path.empty()) {
+                    const int nodelay = 1;
+                    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay,
+                                 sizeof(nodelay));
+                }
+                const uint64_t id = next_id_++;
+                connections_[id].fd = fd;
+                watch(fd, id, EPOLLIN, EPOLL_CTL_ADD);
+                connections_accepted_.fetch_add(1U, RELAXED);
+            }
+        }
+
+        void service(uint64_t id, uint32_t events) {
+            const auto found = connections_.find(id);
+            if (found == connections_.end()) {
+                return;
+            }
+            Connection& connection = found->second;
+
+            if ((events & (EPOLLHUP | EPOLLERR)) != 0U) {
+                // Peer gone in both directions: replies cannot be delivered.
+                ::epoll_ctl(epoll_, EPOLL_CTL_DEL, connection.fd, nullptr);
+                ::close(connection.fd);
+                connections_.erase(found);
+                return;
+            }
+            if ((events & EPOLLOUT) != 0U) {
+                flush(connection);
+            }
+            if ((events & EPOLLIN) != 0U && !connection.paused &&
+                !connection.read_done) {
+                receive(connection);
+                dispatch(id, connection);
+            }
+            settle(id, connection);
+        }
+
+        // Reads at most one chunk per readiness event; epoll is level-
+        // triggered, so a busy connection yields to the others between
+        // chunks. At most one largest frame plus its header is buffered.
+        void receive(Connection& connection) {
+            const size_t limit = options_.max_frame + INGEST_FRAME_HEADER;
+            const size_t buffered = connection.in_end - connection.in_start;
+            if (buffered >= limit) {
+                return;
+            }
+            const size_t want = std::min(INGEST_READ_CHUNK, limit - buffered);
+            if (connection.in.size() - connection.in_end < want) {
+                connection.in.resize(connection.in_end + want);
+            }
+
+            ssize_t got = 0;
+            do {
+                got = ::read(connection.fd,
+                             connection.in.data() + connection.in_end, want);
+            } while (got < 0 && errno == EINTR);
+
+            if (got > 0) {
+                connection.in_end += static_cast<size_t>(got);
+                connection.received = Clock::now();
+            } else if (got == 0 ||
+                       (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                connection.read_done = true;
+            }
+        }
+
+        // Moves every complete frame to the job queue, pausing the
+        // connection when the queue is full. Reads stay off until every
+        // complete frame has been queued, so each one's last byte arrived
+        // with the connection's latest read.
+        void dispatch(uint64_t id, Connection& connection) {
+            while (connection.in_end - connection.in_start >=
+                   INGEST_FRAME_HEADER) {
+                const uint8_t* head =
+                    connection.in.data() + connection.in_start;
+                const size_t length = READ_BE_U32(head);
+                if (length > options_.max_frame) {
+                    IngestReply reply;
+                    reply.sequence = connection.next_sequence++;
+                    reply.status = INGEST_FRAME_TOO_LARGE;
+                    queue_reply(connection, reply);
+                    connection.read_done = true;
+                    connection.in_start = 0U;
+                    connection.in_end = 0U;
+                    return;
+                }
+                if (connection.in_end - connection.in_start <
+                    INGEST_FRAME_HEADER + length) {
+                    break;
+                }
+
+                // Only this thread pushes, so room seen here stays.
+                if (queue_full()) {
+                    if (!connection.paused) {
+                        connection.paused = true;
+                        paused_.push_back(id);
+                        pauses_.fetch_add(1U, RELAXED);
+                    }
+                    break;
+                }
+                Job job;
+                job.connection = id;
+                job.sequence = connection.next_sequence;
+                job.frame.assign(head + INGEST_FRAME_HEADER,
+                                 head + INGEST_FRAME_HEADER + length);
+                job.received = connection.received;
+                push(std::move(job));
+                ++connection.next_sequence;
+                ++connection.in_flight;
+                connection.in_start += INGEST_FRAME_HEADER + length;
+                frames_.fetch_add(1U, RELAXED);
+                bytes_.fetch_add(length, RELAXED);
+            }
+
+            // Move a partial frame to the front; the buffer keeps its size.
+            if (connection.in_start > 0U) {
+                std::copy(connection.in.begin() +
+                              static_cast<ptrdiff_t>(connection.in_start),
+                          connection.in.begin() +
+                              static_cast<ptrdiff_t>(connection.in_end),
+                          connection.in.begin());
+                connection.in_end -= connection.in_start;
+                connection.in_start = 0U;
+            }
+        }
+
+        bool queue_full() {
+            const std::lock_guard<std::mutex> lock(jobs_mutex_);
+            return jobs_.size() >= options_.queue_capacity;
+        }
+
+        void push(Job&& job) {
+            {
+                const std::lock_guard<std::mutex> lock(jobs_mutex_);
+                jobs_.push_back(std::move(job));
+            }
+            jobs_changed_.notify_one();
+        }
+
+        void deliver_completions() {
+            uint64_t counter = 0U;
+            [[maybe_unused]] const ssize_t drained =
+                ::read(wake_, &counter, sizeof(counter));
+
+            std::vector<Completion> done;
+            {
+                const std::lock_guard<std::mutex> lock(done_mutex_);
+                done.swap(done_);
+            }
+            for (const Completion& completion : done) {
+                const auto found = connections_.find(completion.connection);
+                if (found == connections_.end()) {
+                    continue;
+                }
+                --found->second.in_flight;
+                queue_reply(found->second, completion.reply);
+                flush(found->second);
+            }
+            for (const Completion& completion : done) {
+                const auto found = connections_.find(completion.connection);
+                if (found != connections_.end()) {
+                    settle(found->first, found->second);
+                }
+            }
+
+            // Workers made room: resume paused connections in pause order.
+            std::vector<uint64_t> paused;
+            paused.swap(paused_);
+            for (const uint64_t id : paused) {
+                const auto found = connections_.find(id);
+                if (found == connections_.end()) {
+                    continue;
+                }
+                found->second.paused = false;
+                dispatch(id, found->second);
+                settle(id, found->second);
+            }
+        }
+
+        void queue_reply(Connection& connection, const IngestReply& reply) {
+            const size_t offset = connection.out.size();
+            connection.out.resize(offset + INGEST_REPLY_SIZE);
+            WRITE_INGEST_REPLY(reply, connection.out.data() + offset);
+            (reply.status == INGEST_ACCEPTED ? accepted_ : rejected_)
+                .fetch_add(1U, RELAXED);
+        }
+
+        void flush(Connection& connection) {
+            while (connection.out_sent < connection.out.size()) {
+                const ssize_t sent = ::send(
+                    connection.fd, connection.out.data() + connection.out_sent,
+                    connection.out.size() - connection.out_sent,
+                    MSG_NOSIGNAL);
+                if (sent < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (sent <= 0) {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                        connection.read_done = true;  // peer is gone
+                        connection.out.clear();
+                        connection.out_sent = 0U;
+                    }
+                    return;
+                }
+                connection.out_sent += static_cast<size_t>(sent);
+            }
+            connection.out.clear();
+            connection.out_sent = 0U;
+        }
+
+        // Closes a finished connection or updates its epoll interest.
+        void settle(uint64_t id, Connection& connection) {
+            const bool writing = connection.out_sent < connection.out.size();
+            if (connection.read_done && !writing &&
+                connection.in_flight == 0U) {
+                ::epoll_ctl(epoll_, EPOLL_CTL_DEL, connection.fd, nullptr);
+                ::close(connection.fd);
+                connections_.erase(id);
+                return;
+            }
+            uint32_t events = 0U;
+            if (!connection.paused && !connection.read_done) {
+                events |= EPOLLIN;
+            }
+            if (writing) {
+                events |= EPOLLOUT;
+            }
+            watch(connection.fd, id, events, EPOLL_CTL_MOD);
+        }
+
+        // ---- Worker threads ----
+        void work() {
+            while (true) {
+                Job job;
+                {
+                    std::unique_lock<std::mutex> lock(jobs_mutex_);
+                    jobs_changed_.wait(lock, [this]() {
+                        return !jobs_.empty() || stopping_.load(RELAXED);
+                    });
+                    if (stopping_.load(RELAXED)) {
+                        return;
+                    }
+                    job = std::move(jobs_.front());
+                    jobs_.pop_front();
+                }
+
+                IngestReply reply;
+                try {
+                    reply = handler_(job.frame);
+                } catch (...) {
+                    reply = IngestReply{};
+                    reply.status = INGEST_PARSE_FAILED;
+                }
+                reply.sequence = job.sequence;
+                latency_.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        Clock::now() - job.received)
+                        .count()));
+
+                {
+                    const std::lock_guard<std::mutex> lock(done_mutex_);
+                    done_.push_back({job.connection, reply});
+                }
+                signal_loop();
+            }
+        }
+
+        IngestOptions options_;
+        IngestHandler handler_;
+        int listener_ = -1;
+        int epoll_ = -1;
+        int wake_ = -1;
+        uint16_t port_ = 0U;
+        std::atomic<bool> stopping_{false};
+
+        // Owned by the loop thread.
+        std::unordered_map<uint64_t, Connection> connections_;
+        std::vector<uint64_t> paused_;
+        uint64_t next_id_ = WAKE_ID + 1U;
+
+        std::mutex jobs_mutex_;
+        std::condition_variable jobs_changed_;
+        std::deque<Job> jobs_;
+
+        std::mutex done_mutex_;
+        std::vector<Completion> done_;
+
+        std::atomic<uint64_t> connections_accepted_{0U};
+        std::atomic<uint64_t> frames_{0U};
+        std::atomic<uint64_t> bytes_{0U};
+        std::atomic<uint64_t> accepted_{0U};
+        std::atomic<uint64_t> rejected_{0U};
+        std::atomic<uint64_t> pauses_{0U};
+        LatencyHistogram latency_;
+
+        std::vector<std::thread> workers_;
+        std::thread loop_;
+    };
+
+    // --------------------------------------------
+    // Ingest Client (Blocking)
+    // --------------------------------------------
+    // Minimal client for tests and load generation: send() frames one
+    // transaction, receive() blocks for the next reply. Requests may be
+    // pipelined; replies arrive in completion order.
+    class IngestClient {
+      public:
+        explicit IngestClient(const std::string& unix_path) {
+            sockaddr_un address{};
+            if (unix_path.size() >= sizeof(address.sun_path)) {
+                throw std::runtime_error("Socket path too long: " + unix_path);
+            }
+            address.sun_family = AF_UNIX;
+            std::copy(unix_path.begin(), unix_path.end(), address.sun_path);
+            connect_to(AF_UNIX, reinterpret_cast<sockaddr*>(&address),
+                       sizeof(address));
+        }
+
+        explicit IngestClient(uint16_t tcp_port) {
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(tcp_port);
+            connect_to(AF_INET, reinterpret_cast<sockaddr*>(&address),
+                       sizeof(address));
+            const int nodelay = 1;
+            ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &nodelay,
+                         sizeof(nodelay));
+        }
+
+        ~IngestClient() {
+            if (fd_ >= 0) {
+                ::close(fd_);
+            }
+        }
+
+        IngestClient(const IngestClient&) = delete;
+        IngestClient& operator=(const IngestClient&) = delete;
+
+        void send(std::span<const uint8_t> transaction) {
+            uint8_t header[INGEST_FRAME_HEADER];
+            WRITE_BE_U32(header, static_cast<uint32_t>(transaction.size()));
+            std::array<iovec, 2> parts{
+                iovec{header, sizeof(header)},
+                iovec{const_cast<uint8_t*>(transaction.data()),
+                      transaction.size()}};
+
+            size_t part = 0U;
+            while (part < parts.size()) {
+                const ssize_t sent =
+                    ::writev(fd_, &parts[part],
+                             static_cast<int>(parts.size() - part));
+                if (sent < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (sent < 0) {
+                    throw std::runtime_error("Failed to send transaction");
+                }
+                auto remaining = static_cast<size_t>(sent);
+                while (part < parts.size() &&
+                       remaining >= parts[part].iov_len) {
+                    remaining -= parts[part].iov_len;
+                    ++part;
+                }
+                if (part < parts.size()) {
+                    parts[part].iov_base =
+                        static_cast<uint8_t*>(parts[part].iov_base) + remaining;
+                    parts[part].iov_len -= remaining;
+                }
+            }
+        }
+
+        IngestReply receive() {
+            uint8_t reply[INGEST_REPLY_SIZE];
+            size_t got = 0U;
+            while (got < sizeof(reply)) {
+                const ssize_t count =
+                    ::read(fd_, reply + got, sizeof(reply) - got);
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (count <= 0) {
+                    throw std::runtime_error("Ingest connection closed");
+                }
+                got += static_cast<size_t>(count);
+            }
+            return READ_INGEST_REPLY(reply);
+        }
+
+      private:
+        void connect_to(int family, const sockaddr* address,
+                        socklen_t length) {
+            fd_ = ::socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd_ < 0 || ::connect(fd_, address, length) != 0) {
+                if (fd_ >= 0) {
+                    ::close(fd_);
+                }
+                throw std::runtime_error("Failed to connect to ingest server");
+            }
+        }
+
+        int fd_ = -1;
+    };
+
+}  // namespace nnist
+#endif
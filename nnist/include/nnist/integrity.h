@@ -0,0 +1,353 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "nnist/constants.h"
+#include "nnist/parsers.h"
+#include "nnist/scan.h"
+#include "nnist/types.h"
+
+#if !NNIST_FREESTANDING
+#include <vector>
+#endif
+
+namespace nnist {
+
+    // --------------------------------------------
+    // Integrity Errors
+    // --------------------------------------------
+    enum INTEGRITY_ERROR : uint8_t {
+        INTEGRITY_OK = 0,
+        INTEGRITY_BAD_TYPE1,       // no Type-1 header at the start
+        INTEGRITY_BAD_CNT,         // CNT missing, malformed or miscounted
+        INTEGRITY_TRUNCATED,       // a record runs past the buffer
+        INTEGRITY_BAD_LEN,         // no readable LEN where a record starts
+        INTEGRITY_LEN_MISMATCH,    // tagged LEN does not end on FS
+        INTEGRITY_TYPE_MISMATCH,   // record type differs from the CNT plan
+        INTEGRITY_IDC_MISMATCH,    // record IDC differs from the CNT plan
+        INTEGRITY_BAD_FIELD_TAG,   // not "<record type>.<n>:"
+        INTEGRITY_BAD_SEPARATOR,   // FS before the end of a record
+        INTEGRITY_TRAILING_BYTES   // bytes after the last planned record
+    };
+
+    inline const char* INTEGRITY_ERROR_MESSAGE(INTEGRITY_ERROR error) noexcept {
+        switch (error) {
+            case INTEGRITY_OK:
+                return "OK";
+            case INTEGRITY_BAD_TYPE1:
+                return "Missing Type-1 record";
+            case INTEGRITY_BAD_CNT:
+                return "Invalid CNT field";
+            case INTEGRITY_TRUNCATED:
+                return "Truncated record";
+            case INTEGRITY_BAD_LEN:
+                return "Invalid record LEN";
+            case INTEGRITY_LEN_MISMATCH:
+                return "LEN does not end on FS";
+            case INTEGRITY_TYPE_MISMATCH:
+                return "Record type does not match CNT";
+            case INTEGRITY_IDC_MISMATCH:
+                return "Record IDC does not match CNT";
+            case INTEGRITY_BAD_FIELD_TAG:
+                return "Invalid field tag";
+            case INTEGRITY_BAD_SEPARATOR:
+                return "FS inside record";
+            case INTEGRITY_TRAILING_BYTES:
+                return "Trailing bytes after last record";
+        }
+        return "Unknown integrity error";
+    }
+
+    struct IntegrityError {
+        INTEGRITY_ERROR error = INTEGRITY_OK;
+        int record_type = -1;
+        size_t record_index = 0U;  // CNT ordinal; 0 is the Type-1 record
+        size_t offset = 0U;        // offending byte, absolute
+    };
+
+    // --------------------------------------------
+    // Separator Search
+    // --------------------------------------------
+    constexpr uint64_t SWAR_ONES = 0x0101010101010101ULL;
+    constexpr uint64_t SWAR_HIGH_BITS = 0x8080808080808080ULL;
+    constexpr uint8_t SEPARATOR_MASK = 0xFCU;  // FS..US are 0x1C..0x1F
+
+    // Offset of the first FS/GS/RS/US byte in [from, size), or the size.
+    // Eight bytes per step: a word holds a separator iff some byte of
+    // (word & 0xFC..) ^ 0x1C.. is zero.
+    inline size_t FIND_SEPARATOR(std::span<const uint8_t> bytes,
+                                 size_t from) noexcept {
+        constexpr uint64_t MASK = SWAR_ONES * SEPARATOR_MASK;
+        constexpr uint64_t PATTERN = SWAR_ONES * FS;
+
+        while (bytes.size() - from >= sizeof(uint64_t)) {
+            uint64_t word = 0U;
+            std::memcpy(&word, bytes.data() + from, sizeof(word));
+            const uint64_t probe = (word & MASK) ^ PATTERN;
+            if (((probe - SWAR_ONES) & ~probe & SWAR_HIGH_BITS) != 0U) {
+                break;
+            }
+            from += sizeof(word);
+        }
+        while (from < bytes.size() && (bytes[from] & SEPARATOR_MASK) != FS) {
+            ++from;
+        }
+        return from;
+    }
+
+    // --------------------------------------------
+    // Tagged Record Check
+    // --------------------------------------------
+    // Walks the fields of one tagged record (its exact LEN span, already
+    // known to end in FS). Every tag must read "<record_type>.<n>:" and FS
+    // may only close the record; US/RS are skipped. A ".999" payload is not
+    // read. on_field(field_number, value) sees every other field.
+    template <typename OnField>
+    inline INTEGRITY_ERROR CHECK_TAGGED_FIELDS(
+        std::span<const uint8_t> record, int record_type,
+        size_t& error_offset, OnField&& on_field) {
+        const size_t last = record.size() - 1U;  // the closing FS
+        size_t position = 0U;
+
+        while (position < last) {
+            const size_t colon = FIND_DELIMITER(record, position, ':', GS);
+            const auto tag = record.subspan(position, colon - position);
+            int tag_type = -1;
+            size_t field_number = 0U;
+            if (colon >= last || record[colon] != ':' ||
+                !PARSE_FIELD_TAG(tag, tag_type, field_number) ||
+                tag_type != record_type) {
+                error_offset = position;
+                return INTEGRITY_BAD_FIELD_TAG;
+            }
+            if (TAG_ENDS_WITH(tag, ".999")) {
+                return INTEGRITY_OK;  // payload runs to the LEN
+            }
+
+            size_t end = FIND_SEPARATOR(record, colon + 1U);
+            while (record[end] == US || record[end] == RS) {
+                end = FIND_SEPARATOR(record, end + 1U);
+            }
+            if (record[end] == FS && end != last) {
+                error_offset = end;
+                return INTEGRITY_BAD_SEPARATOR;
+            }
+
+            on_field(field_number,
+                     record.subspan(colon + 1U, end - colon - 1U));
+            position = end + 1U;
+        }
+        return INTEGRITY_OK;
+    }
+
+    // Record count declared by the first CNT subfield: "1<US><others>" in
+    // the standard form, a single total otherwise (see CNT_MATCHES_RECORDS).
+    inline bool READ_CNT_DECLARED_RECORDS(std::span<const uint8_t> cnt,
+                                          size_t& records) noexcept {
+        const size_t first_end = FIND_DELIMITER(cnt, 0U, RS, RS);
+        const size_t unit = FIND_DELIMITER(cnt, 0U, US, RS);
+        if (unit < first_end) {
+            if (!PARSE_UNSIGNED(cnt.subspan(unit + 1U), records)) {
+                return false;
+            }
+            ++records;  // plus the Type-1 record
+            return true;
+        }
+        return PARSE_UNSIGNED(cnt.first(first_end), records);
+    }
+
+    // --------------------------------------------
+    // Validate-Only Transaction Scan
+    // --------------------------------------------
+    // Checks that the transaction at the start of `buffer` is structurally
+    // sound without building a File: the CNT plan is well formed and
+    // counts its entries, each planned record has a LEN in bounds whose
+    // last byte is FS (tagged) and whose next byte starts the next record,
+    // its type and IDC match the plan, field tags and separators nest, and
+    // nothing follows the last record. Only tagged text is read, eight bytes
+    // per step; binary records and ".999" payloads are skipped by LEN.
+    // sink(const IntegrityError&) returns false to stop (first-error mode).
+    // Errors that lose the record boundaries end the scan. Returns the
+    // number of errors reported. Never allocates.
+    template <typename Sink>
+    inline size_t VALIDATE_TRANSACTION_INTEGRITY(
+        std::span<const uint8_t> buffer, Sink&& sink) {
+        size_t errors = 0U;
+        bool stopped = false;
+        const auto report = [&](INTEGRITY_ERROR error, int record_type,
+                                size_t record_index, size_t offset) {
+            ++errors;
+            stopped = !sink(static_cast<const IntegrityError&>(
+                IntegrityError{error, record_type, record_index, offset}));
+            return !stopped;
+        };
+
+        // ---- Type-1 and its CNT plan ----
+        int type1_type = -1;
+        size_t type1_length = 0U;
+        if (!READ_TAGGED_HEADER(buffer, 0U, type1_type, type1_length) ||
+            type1_type != RECORD_TYPE_1) {
+            report(INTEGRITY_BAD_TYPE1, -1, 0U, 0U);
+            return errors;
+        }
+        if (type1_length > buffer.size()) {
+            report(INTEGRITY_TRUNCATED, RECORD_TYPE_1, 0U, buffer.size());
+            return errors;
+        }
+        const auto type1 = buffer.first(type1_length);
+        if (type1.back() != FS) {
+            report(INTEGRITY_LEN_MISMATCH, RECORD_TYPE_1, 0U,
+                   type1_length - 1U);
+            return errors;
+        }
+
+        std::span<const uint8_t> cnt;
+        bool has_cnt = false;
+        size_t error_offset = 0U;
+        const INTEGRITY_ERROR type1_error = CHECK_TAGGED_FIELDS(
+            type1, RECORD_TYPE_1, error_offset,
+            [&](size_t field_number, std::span<const uint8_t> value) {
+                if (field_number == CNT_FIELD && !has_cnt) {
+                    cnt = value;
+                    has_cnt = true;
+                }
+            });
+        if (type1_error != INTEGRITY_OK &&
+            !report(type1_error, RECORD_TYPE_1, 0U, error_offset)) {
+            return errors;
+        }
+
+        const size_t cnt_offset =
+            has_cnt ? static_cast<size_t>(cnt.data() - buffer.data()) : 0U;
+        size_t planned = 1U;
+        const PARSE_STATUS plan_status =
+            FOR_EACH_CNT_ENTRY(type1, [&](int, int) {
+                ++planned;
+                return true;
+            });
+        size_t declared = 0U;
+        if (!has_cnt || plan_status != PARSE_OK) {
+            report(INTEGRITY_BAD_CNT, RECORD_TYPE_1, 0U, cnt_offset);
+            return errors;
+        }
+        if ((!READ_CNT_DECLARED_RECORDS(cnt, declared) ||
+             declared != planned) &&
+            !report(INTEGRITY_BAD_CNT, RECORD_TYPE_1, 0U, cnt_offset)) {
+            return errors;
+        }
+
+        // ---- Planned records, by LEN hops ----
+        size_t position = type1_length;
+        size_t record_index = 0U;
+        bool lost = false;
+        FOR_EACH_CNT_ENTRY(type1, [&](int record_type, int idc) {
+            ++record_index;
+            const size_t remaining = buffer.size() - position;
+            const auto fail = [&](INTEGRITY_ERROR error, size_t offset) {
+                lost = true;
+                report(error, record_type, record_index, offset);
+                return false;
+            };
+
+            if (remaining < MIN_BINARY_RECORD_SIZE) {
+                return fail(remaining == 0U ? INTEGRITY_TRUNCATED
+                                            : INTEGRITY_BAD_LEN,
+                            position);
+            }
+
+            if (IS_LEGACY_BINARY_TYPE(record_type)) {
+                const size_t length = READ_BE_U32(buffer.data() + position);
+                if (length < MIN_BINARY_RECORD_SIZE) {
+                    return fail(INTEGRITY_BAD_LEN, position);
+                }
+                if (length > remaining) {
+                    return fail(INTEGRITY_TRUNCATED, position);
+                }
+                if (buffer[position + BINARY_IDC_OFFSET] != idc &&
+                    !report(INTEGRITY_IDC_MISMATCH, record_type,
+                            record_index, position + BINARY_IDC_OFFSET)) {
+                    return false;
+                }
+                position += length;
+                return true;
+            }
+
+            int tagged_type = -1;
+            size_t length = 0U;
+            if (!READ_TAGGED_HEADER(buffer, position, tagged_type, length)) {
+                return fail(INTEGRITY_BAD_LEN, position);
+            }
+            if (length > remaining) {
+                return fail(INTEGRITY_TRUNCATED, position);
+            }
+            const auto record = buffer.subspan(position, length);
+            if (record.back() != FS) {
+                return fail(INTEGRITY_LEN_MISMATCH, position + length - 1U);
+            }
+            if (tagged_type != record_type &&
+                !report(INTEGRITY_TYPE_MISMATCH, record_type, record_index,
+                        position)) {
+                return false;
+            }
+
+            size_t idc_offset = INVALID_INDEX;
+            const INTEGRITY_ERROR field_error = CHECK_TAGGED_FIELDS(
+                record, tagged_type, error_offset,
+                [&](size_t field_number, std::span<const uint8_t> value) {
+                    size_t value_idc = 0U;
+                    if (field_number == IDC_FIELD &&
+                        idc_offset == INVALID_INDEX &&
+                        (!PARSE_UNSIGNED(value, value_idc) ||
+                         value_idc != static_cast<size_t>(idc))) {
+                        idc_offset = static_cast<size_t>(value.data() -
+                                                         buffer.data());
+                    }
+                });
+            if (field_error != INTEGRITY_OK &&
+                !report(field_error, record_type, record_index,
+                        position + error_offset)) {
+                return false;
+            }
+            if (idc_offset != INVALID_INDEX &&
+                !report(INTEGRITY_IDC_MISMATCH, record_type, record_index,
+                        idc_offset)) {
+                return false;
+            }
+
+            position += length;
+            return true;
+        });
+
+        if (!lost && !stopped && position != buffer.size()) {
+            report(INTEGRITY_TRAILING_BYTES, -1, record_index + 1U, position);
+        }
+        return errors;
+    }
+
+    // First error only, or INTEGRITY_OK.
+    inline IntegrityError FIRST_INTEGRITY_ERROR(
+        std::span<const uint8_t> buffer) {
+        IntegrityError first;
+        VALIDATE_TRANSACTION_INTEGRITY(buffer,
+                                       [&](const IntegrityError& error) {
+                                           first = error;
+                                           return false;
+                                       });
+        return first;
+    }
+
+#if !NNIST_FREESTANDING
+    inline std::vector<IntegrityError> VALIDATE_INTEGRITY(
+        std::span<const uint8_t> buffer) {
+        std::vector<IntegrityError> errors;
+        VALIDATE_TRANSACTION_INTEGRITY(buffer,
+                                       [&](const IntegrityError& error) {
+                                           errors.push_back(error);
+                                           return true;
+                                       });
+        return errors;
+    }
+#endif
+
+}  // namespace nnist
@@ -0,0 +1,112 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "nnist/parsers.h"
+#include "nnist/scan.h"
+#include "nnist/types.h"
+
+namespace nnist {
+
+    inline uint64_t RECORD_KEY(int record_type, int idc) noexcept {
+        constexpr uint32_t KEY_SHIFT = 32U;
+        return (static_cast<uint64_t>(static_cast<uint32_t>(record_type))
+                << KEY_SHIFT) |
+               static_cast<uint32_t>(idc);
+    }
+
+    // --------------------------------------------
+    // Record Locator (Lazy Random Access)
+    // --------------------------------------------
+    // Indexes a transaction by one boundary scan (Type-1 CNT plus LEN hops)
+    // and parses a record only when it is requested. The buffer is borrowed
+    // and must outlive the locator; pair it with a MappedFile so that only
+    // the Type-1 record, the LEN prefixes and the requested records are ever
+    // paged in.
+    class RecordLocator {
+      public:
+        explicit RecordLocator(std::span<const uint8_t> buffer)
+            : buffer_(buffer) {
+            size_t end_offset = 0U;
+            const PARSE_STATUS status = SCAN_RECORDS(
+                buffer_, 0U,
+                [this](const RecordSpan& span) {
+                    index_.try_emplace(RECORD_KEY(span.type, span.idc),
+                                       spans_.size());
+                    spans_.push_back(span);
+                    return true;
+                },
+                end_offset);
+            if (status != PARSE_OK) {
+                throw std::runtime_error(PARSE_STATUS_MESSAGE(status));
+            }
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return spans_.size(); }
+
+        [[nodiscard]] const std::vector<RecordSpan>& spans() const noexcept {
+            return spans_;
+        }
+
+        [[nodiscard]] const RecordSpan& at(size_t ordinal) const {
+            return spans_.at(ordinal);
+        }
+
+        // First record with the given (type, IDC); nullptr when absent. The
+        // Type-1 record is keyed with IDC -1.
+        [[nodiscard]] const RecordSpan* find(int record_type,
+                                             int idc) const noexcept {
+            const auto it = index_.find(RECORD_KEY(record_type, idc));
+            return it == index_.end() ? nullptr : &spans_[it->second];
+        }
+
+        [[nodiscard]] std::span<const uint8_t> bytes(
+            const RecordSpan& span) const noexcept {
+            return buffer_.subspan(span.offset, span.length);
+        }
+
+        template <typename Storage>
+        PARSE_STATUS parse_into(const RecordSpan& span,
+                                BasicRecord<Storage>& record) const {
+            Cursor cursor{bytes(span)};
+            const PARSE_STATUS status =
+                PARSE_RECORD_OF_TYPE(cursor, span.type, record);
+            record.type = span.type;
+            record.idc = span.idc;
+            SET_SOURCE_SPAN(record, buffer_, span.offset, span.length);
+            return status;
+        }
+
+        [[nodiscard]] Record parse(size_t ordinal) const {
+            Record record;
+            const PARSE_STATUS status = parse_into(at(ordinal), record);
+            if (status != PARSE_OK) {
+                throw std::runtime_error(PARSE_STATUS_MESSAGE(status));
+            }
+            return record;
+        }
+
+        [[nodiscard]] std::optional<Record> parse(int record_type,
+                                                  int idc) const {
+            const RecordSpan* span = find(record_type, idc);
+            if (span == nullptr) {
+                return std::nullopt;
+            }
+            return parse(static_cast<size_t>(span - spans_.data()));
+        }
+
+      private:
+        std::span<const uint8_t> buffer_;
+        std::vector<RecordSpan> spans_;
+        std::unordered_map<uint64_t, size_t> index_;
+    };
+
+}  // namespace nnist
+#endif
@@ -0,0 +1,127 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nnist {
+
+    // --------------------------------------------
+    // Mapped File (Read-Only)
+    // --------------------------------------------
+    // Maps a file into memory so records can be located and parsed without
+    // reading the whole file. Pages are faulted in only when touched. On
+    // platforms without mmap the file is read into memory instead.
+    class MappedFile {
+      public:
+        explicit MappedFile(const std::filesystem::path& path) {
+#if defined(_WIN32)
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("Failed to open file: " +
+                                         path.string());
+            }
+            fallback_.assign(std::istreambuf_iterator<char>(file),
+                             std::istreambuf_iterator<char>());
+            data_ = fallback_.data();
+            size_ = fallback_.size();
+#else
+            descriptor_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (descriptor_ < 0) {
+                throw std::runtime_error("Failed to open file: " +
+                                         path.string());
+            }
+
+            struct stat info {};
+            if (::fstat(descriptor_, &info) != 0) {
+                ::close(descriptor_);
+                throw std::runtime_error("Failed to stat file: " +
+                                         path.string());
+            }
+            size_ = static_cast<size_t>(info.st_size);
+
+            if (size_ > 0U) {
+                void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED,
+                                       descriptor_, 0);
+                if (mapping == MAP_FAILED) {
+                    ::close(descriptor_);
+                    throw std::runtime_error("Failed to map file: " +
+                                             path.string());
+                }
+                data_ = static_cast<const uint8_t*>(mapping);
+            }
+#endif
+        }
+
+        ~MappedFile() { release(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept { take(other); }
+
+        MappedFile& operator=(MappedFile&& other) noexcept {
+            if (this != &other) {
+                release();
+                take(other);
+            }
+            return *this;
+        }
+
+        [[nodiscard]] std::span<const uint8_t> bytes() const noexcept {
+            return {data_, size_};
+        }
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+
+        // Native descriptor (-1 when the file was read into memory).
+        [[nodiscard]] int descriptor() const noexcept { return descriptor_; }
+
+      private:
+        void release() noexcept {
+#if !defined(_WIN32)
+            if (data_ != nullptr) {
+                ::munmap(const_cast<uint8_t*>(data_), size_);
+            }
+            if (descriptor_ >= 0) {
+                ::close(descriptor_);
+            }
+#endif
+            data_ = nullptr;
+            size_ = 0U;
+            descriptor_ = -1;
+        }
+
+        void take(MappedFile& other) noexcept {
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0U);
+            descriptor_ = std::exchange(other.descriptor_, -1);
+#if defined(_WIN32)
+            fallback_ = std::move(other.fallback_);
+#endif
+        }
+
+        const uint8_t* data_ = nullptr;
+        size_t size_ = 0U;
+        int descriptor_ = -1;
+#if defined(_WIN32)
+        std::vector<uint8_t> fallback_;
+#endif
+    };
+
+}  // namespace nnist
+#endif
@@ -1,5 +1,25 @@
 #pragma once
+#include <nnist/cache.h>
+#include <nnist/charset.h>
+#include <nnist/compose.h>
 #include <nnist/constants.h>
+#include <nnist/diff.h>
+#include <nnist/extract.h>
+#include <nnist/hash.h>
+#include <nnist/header.h>
+#include <nnist/ingest.h>
+#include <nnist/integrity.h>
+#include <nnist/locator.h>
+#include <nnist/mapped_file.h>
+#include <nnist/parallel.h>
 #include <nnist/parsers.h>
+#include <nnist/scan.h>
+#include <nnist/schema.h>
 #include <nnist/serdes.h>
+#include <nnist/serdes_parallel.h>
+#include <nnist/shared.h>
+#include <nnist/split.h>
+#include <nnist/stream.h>
+#include <nnist/storage.h>
+#include <nnist/type9.h>
 #include <nnist/types.h>
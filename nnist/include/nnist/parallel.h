@@ -0,0 +1,76 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nnist {
+
+    inline size_t DEFAULT_THREAD_COUNT() noexcept {
+        const unsigned int hardware = std::thread::hardware_concurrency();
+        return hardware == 0U ? 1U : static_cast<size_t>(hardware);
+    }
+
+    // --------------------------------------------
+    // Parallel For (Dynamic Scheduling)
+    // --------------------------------------------
+    // Runs fn(index) for every index in [0, count) on up to `thread_count`
+    // threads (0 = hardware concurrency). Indices are handed out one at a
+    // time so uneven work (e.g. image-heavy records) balances itself. The
+    // first exception thrown by fn is rethrown on the calling thread.
+    template <typename Fn>
+    inline void PARALLEL_FOR(size_t count, size_t thread_count, Fn&& fn) {
+        if (thread_count == 0U) {
+            thread_count = DEFAULT_THREAD_COUNT();
+        }
+        if (thread_count > count) {
+            thread_count = count;
+        }
+        if (thread_count <= 1U) {
+            for (size_t i = 0; i < count; i++) {
+                fn(i);
+            }
+            return;
+        }
+
+        std::atomic<size_t> next{0U};
+        std::exception_ptr failure;
+        std::mutex failure_mutex;
+
+        auto worker = [&]() {
+            for (size_t i = next.fetch_add(1U); i < count;
+                 i = next.fetch_add(1U)) {
+                try {
+                    fn(i);
+                } catch (...) {
+                    const std::lock_guard<std::mutex> lock(failure_mutex);
+                    if (!failure) {
+                        failure = std::current_exception();
+                    }
+                    next.store(count);
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count - 1U);
+        for (size_t t = 1; t < thread_count; t++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+}  // namespace nnist
+#endif
@@ -1,18 +1,60 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
-#include <filesystem>
-#include <fstream>
 #include <span>
-#include <stdexcept>
-#include <string>
-#include <vector>
+#include <string_view>
+#include <utility>
 
 #include "nnist/constants.h"
+#include "nnist/hash.h"
+#include "nnist/storage.h"
 #include "nnist/types.h"
 
+#if !NNIST_FREESTANDING
+#include <stdexcept>
+#include <string>
+#include <vector>
+#endif
+
 namespace nnist {
 
+    // --------------------------------------------
+    // Parse Status (Exception-Free Core)
+    // --------------------------------------------
+    enum PARSE_STATUS : uint8_t {
+        PARSE_OK = 0,
+        PARSE_CAPACITY_EXCEEDED,
+        PARSE_BINARY_EOF,
+        PARSE_INVALID_BINARY_LEN,
+        PARSE_INVALID_CNT,
+        PARSE_INVALID_TAGGED_LEN,
+        PARSE_TRUNCATED,
+        PARSE_INVALID_FIELD_TAG
+    };
+
+    inline const char* PARSE_STATUS_MESSAGE(PARSE_STATUS status) noexcept {
+        switch (status) {
+            case PARSE_OK:
+                return "OK";
+            case PARSE_CAPACITY_EXCEEDED:
+                return "Storage capacity exceeded";
+            case PARSE_BINARY_EOF:
+                return "Binary record EOF";
+            case PARSE_INVALID_BINARY_LEN:
+                return "Invalid binary LEN";
+            case PARSE_INVALID_CNT:
+                return "Invalid CNT entry";
+            case PARSE_INVALID_TAGGED_LEN:
+                return "Invalid tagged LEN";
+            case PARSE_TRUNCATED:
+                return "Truncated transaction";
+            case PARSE_INVALID_FIELD_TAG:
+                return "Invalid field tag";
+        }
+        return "Unknown parse status";
+    }
+
     // --------------------------------------------
     // Cursor (Safe Span-Based Reader)
     // --------------------------------------------
@@ -31,6 +73,9 @@ namespace nnist {
             return buffer_.size() - position_;
         }
         [[nodiscard]] size_t size() const noexcept { return buffer_.size(); }
+        [[nodiscard]] const uint8_t* data() const noexcept {
+            return buffer_.data();
+        }
 
         void seek(size_t new_position) noexcept { position_ = new_position; }
 
@@ -84,7 +129,7 @@ namespace nnist {
     // Binary Record Type Check
     // --------------------------------------------
 
-    inline bool IS_LEGACY_BINARY_TYPE(int record_type) noexcept {
+    constexpr bool IS_LEGACY_BINARY_TYPE(int record_type) noexcept {
         switch (record_type) {
             case RECORD_TYPE_3:
             case RECORD_TYPE_4:
@@ -98,24 +143,117 @@ namespace nnist {
         }
     }
 
+    // --------------------------------------------
+    // Tag / Number Helpers (No Allocation)
+    // --------------------------------------------
+    inline bool TAG_EQUALS(std::span<const uint8_t> tag,
+                           std::string_view expected) noexcept {
+        if (tag.size() != expected.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < tag.size(); i++) {
+            if (tag[i] != static_cast<uint8_t>(expected[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline bool TAG_ENDS_WITH(std::span<const uint8_t> tag,
+                              std::string_view suffix) noexcept {
+        if (tag.size() < suffix.size()) {
+            return false;
+        }
+        return TAG_EQUALS(tag.last(suffix.size()), suffix);
+    }
+
+    // Parses the leading decimal digits of `digits`. Returns false when there
+    // are none or the value overflows.
+    inline bool PARSE_UNSIGNED(std::span<const uint8_t> digits,
+                               size_t& value) noexcept {
+        constexpr size_t DECIMAL_BASE = 10U;
+        value = 0U;
+        size_t count = 0U;
+
+        for (const uint8_t digit : digits) {
+            if (digit < '0' || digit > '9') {
+                break;
+            }
+            const auto next = static_cast<size_t>(digit - '0');
+            if (value > (INVALID_INDEX - next) / DECIMAL_BASE) {
+                return false;
+            }
+            value = value * DECIMAL_BASE + next;
+            ++count;
+        }
+
+        return count > 0U;
+    }
+
+    // Field number of a "<type>.<field>" tag: the digits after the last
+    // dot, which must run to the end of the tag. Zero padding is accepted
+    // only up to the three-digit field width, so the number is 999 exactly
+    // when the tag ends in ".999". INVALID_INDEX for anything else.
+    inline size_t TAG_FIELD_NUMBER(std::span<const uint8_t> tag) noexcept {
+        constexpr size_t PADDED_FIELD_WIDTH = 3U;
+        size_t dot = tag.size();
+        while (dot > 0U && tag[dot - 1U] != static_cast<uint8_t>('.')) {
+            --dot;
+        }
+        const auto digits = tag.subspan(dot);
+        if (dot == 0U || digits.empty() ||
+            (digits.size() > PADDED_FIELD_WIDTH && digits[0] == '0')) {
+            return INVALID_INDEX;
+        }
+        for (const uint8_t digit : digits) {
+            if (digit < '0' || digit > '9') {
+                return INVALID_INDEX;
+            }
+        }
+        size_t number = 0U;
+        return PARSE_UNSIGNED(digits, number) ? number : INVALID_INDEX;
+    }
+
+    inline size_t DECIMAL_DIGITS(size_t value) noexcept {
+        constexpr size_t DECIMAL_BASE = 10U;
+        size_t digits = 1U;
+        while (value >= DECIMAL_BASE) {
+            value /= DECIMAL_BASE;
+            ++digits;
+        }
+        return digits;
+    }
+
+    // Value for a tagged LEN field whose record is `base` bytes without the
+    // LEN digits: the LEN counts its own digits.
+    inline size_t SELF_COUNTING_LENGTH(size_t base) noexcept {
+        size_t digits = 1U;
+        while (DECIMAL_DIGITS(base + digits) != digits) {
+            ++digits;
+        }
+        return base + digits;
+    }
+
     // --------------------------------------------
     // Token Extraction
     // --------------------------------------------
-    inline std::vector<uint8_t> TAKE_UNTIL(Cursor& cursor, uint8_t delimiter) {
+    template <typename Bytes>
+    inline Bytes TAKE_UNTIL(Cursor& cursor, uint8_t delimiter) {
         const size_t start_position = cursor.position();
 
         while (!cursor.done() && cursor.peek() != delimiter) {
             cursor.advance();
         }
 
-        auto bytes = cursor.slice(start_position, cursor.position());
-        return {bytes.begin(), bytes.end()};
+        return MAKE_BYTES<Bytes>(
+            cursor.slice(start_position, cursor.position()));
     }
 
     // --------------------------------------------
     // Item Parsing
     // --------------------------------------------
-    inline Item PARSE_ITEM(Cursor& cursor) {
+    template <typename Storage>
+    inline BasicItem<Storage> PARSE_ITEM(Cursor& cursor) {
         const size_t start_position = cursor.position();
 
         while (!cursor.done()) {
@@ -126,18 +264,20 @@ namespace nnist {
             cursor.advance();
         }
 
-        auto bytes = cursor.slice(start_position, cursor.position());
-        return {{bytes.begin(), bytes.end()}};
+        return {MAKE_BYTES<typename Storage::Bytes>(
+            cursor.slice(start_position, cursor.position()))};
     }
 
     // --------------------------------------------
     // Subfield Parsing
     // --------------------------------------------
-    inline Subfield PARSE_SUBFIELD(Cursor& cursor) {
-        Subfield subfield;
-
+    template <typename Storage>
+    inline PARSE_STATUS PARSE_SUBFIELD_INTO(Cursor& cursor,
+                                            BasicSubfield<Storage>& subfield) {
         while (!cursor.done()) {
-            subfield.items.push_back(PARSE_ITEM(cursor));
+            if (!APPEND(subfield.items, PARSE_ITEM<Storage>(cursor))) {
+                return PARSE_CAPACITY_EXCEEDED;
+            }
 
             if (cursor.done()) {
                 break;
@@ -151,14 +291,24 @@ namespace nnist {
             break;
         }
 
+        return PARSE_OK;
+    }
+
+#if !NNIST_FREESTANDING
+    inline Subfield PARSE_SUBFIELD(Cursor& cursor) {
+        Subfield subfield;
+        PARSE_SUBFIELD_INTO(cursor, subfield);
         return subfield;
     }
+#endif
 
     // --------------------------------------------
     // Binary Field Parsing
     // --------------------------------------------
-    inline Field PARSE_BINARY_FIELD(Cursor& cursor, size_t record_end) {
-        Field field;
+    template <typename Storage>
+    inline PARSE_STATUS PARSE_BINARY_FIELD_INTO(Cursor& cursor,
+                                                size_t record_end,
+                                                BasicField<Storage>& field) {
         field.is_binary_field = true;
 
         const size_t start_position = cursor.position();
@@ -181,20 +331,36 @@ namespace nnist {
             cursor.seek(end_position);
         }
 
-        auto bytes = cursor.slice(start_position, end_position);
-        field.raw_field.assign(bytes.begin(), bytes.end());
+        field.raw_field = MAKE_BYTES<typename Storage::Bytes>(
+            cursor.slice(start_position, end_position));
+
+        return PARSE_OK;
+    }
 
+#if !NNIST_FREESTANDING
+    inline Field PARSE_BINARY_FIELD(Cursor& cursor, size_t record_end) {
+        Field field;
+        PARSE_BINARY_FIELD_INTO(cursor, record_end, field);
         return field;
     }
+#endif
 
     // --------------------------------------------
     // Text Field Parsing
     // --------------------------------------------
-    inline Field PARSE_TEXT_FIELD(Cursor& cursor) {
-        Field field;
-
+    template <typename Storage>
+    inline PARSE_STATUS PARSE_TEXT_FIELD_INTO(Cursor& cursor,
+                                              BasicField<Storage>& field) {
         while (!cursor.done() && cursor.peek() != GS && cursor.peek() != FS) {
-            field.subfields.push_back(PARSE_SUBFIELD(cursor));
+            auto* subfield = EMPLACE(field.subfields);
+            if (subfield == nullptr) {
+                return PARSE_CAPACITY_EXCEEDED;
+            }
+
+            const PARSE_STATUS status = PARSE_SUBFIELD_INTO(cursor, *subfield);
+            if (status != PARSE_OK) {
+                return status;
+            }
 
             if (!cursor.done() && cursor.peek() == RS) {
                 cursor.advance();
@@ -204,82 +370,119 @@ namespace nnist {
             break;
         }
 
+        return PARSE_OK;
+    }
+
+#if !NNIST_FREESTANDING
+    inline Field PARSE_TEXT_FIELD(Cursor& cursor) {
+        Field field;
+        PARSE_TEXT_FIELD_INTO(cursor, field);
         return field;
     }
+#endif
 
     // --------------------------------------------
     // Field Dispatcher
     // --------------------------------------------
-    inline Field PARSE_FIELD(Cursor& cursor, size_t record_end) {
-        Field field;
-        field.tag = TAKE_UNTIL(cursor, static_cast<uint8_t>(':'));
+    template <typename Storage>
+    inline void PARSE_TAG_INTO(Cursor& cursor, BasicField<Storage>& field) {
+        field.tag = TAKE_UNTIL<typename Storage::Bytes>(
+            cursor, static_cast<uint8_t>(':'));
 
         if (!cursor.done() && cursor.peek() == static_cast<uint8_t>(':')) {
             cursor.advance();
         }
+    }
 
-        const std::string tag_string(field.tag.begin(), field.tag.end());
-
-        if (tag_string.ends_with(".999")) {
-            Field parsed = PARSE_BINARY_FIELD(cursor, record_end);
-            parsed.tag = std::move(field.tag);  // <-- keep tag
-            return parsed;
+    // Parses the value after the tag: a payload bounded by `record_end`
+    // when `is_image`, otherwise subfields and items.
+    template <typename Storage>
+    inline PARSE_STATUS PARSE_FIELD_VALUE_INTO(Cursor& cursor,
+                                               size_t record_end,
+                                               bool is_image,
+                                               BasicField<Storage>& field) {
+        if (is_image) {
+            return PARSE_BINARY_FIELD_INTO(cursor, record_end, field);
         }
+        return PARSE_TEXT_FIELD_INTO(cursor, field);
+    }
 
-        Field parsed = PARSE_TEXT_FIELD(cursor);
-        parsed.tag = std::move(field.tag);  // <-- keep tag
-        return parsed;
+    // BINARY_FIELDS = false skips the ".999" check for record types known
+    // to carry no image payload (see RecordParser).
+    template <bool BINARY_FIELDS = true, typename Storage>
+    inline PARSE_STATUS PARSE_FIELD_INTO(Cursor& cursor, size_t record_end,
+                                         BasicField<Storage>& field) {
+        PARSE_TAG_INTO(cursor, field);
+        return PARSE_FIELD_VALUE_INTO(
+            cursor, record_end,
+            BINARY_FIELDS && TAG_ENDS_WITH(field.tag, ".999"), field);
     }
 
+#if !NNIST_FREESTANDING
+    inline Field PARSE_FIELD(Cursor& cursor, size_t record_end) {
+        Field field;
+        PARSE_FIELD_INTO(cursor, record_end, field);
+        return field;
+    }
+#endif
+
     // --------------------------------------------
     // LEN Parsing
     // --------------------------------------------
-    inline size_t PARSE_LEN_FROM_FIRST_FIELD(const Field& first_field) {
+    template <typename Storage>
+    inline size_t PARSE_LEN_FROM_FIRST_FIELD(
+        const BasicField<Storage>& first_field) noexcept {
         if (first_field.subfields.empty() ||
             first_field.subfields[0].items.empty()) {
             return 0U;
         }
 
-        const std::string tag(first_field.tag.begin(), first_field.tag.end());
-
-        if (!tag.ends_with(".001") && !tag.ends_with(".01")) {
+        if (!TAG_ENDS_WITH(first_field.tag, ".001") &&
+            !TAG_ENDS_WITH(first_field.tag, ".01")) {
             return 0U;
         }
 
-        const auto& bytes = first_field.subfields[0].items[0].bytes;
-        const std::string value(bytes.begin(), bytes.end());
-
-        try {
-            return std::stoul(value);
-        } catch (...) {
+        size_t value = 0U;
+        if (!PARSE_UNSIGNED(first_field.subfields[0].items[0].bytes, value)) {
             return 0U;
         }
+        return value;
     }
 
     // --------------------------------------------
     // Tagged Record Parsing
     // --------------------------------------------
-    inline Record PARSE_RECORD(Cursor& cursor) {
-        Record record;
+    // classify(index, tag) runs once per field, right after its tag is read,
+    // and returns true when the value is an image payload. Per-type parsers
+    // use it to pick out the fields they know about without a second pass.
+    template <typename Storage, typename Classify>
+    inline PARSE_STATUS PARSE_TAGGED_RECORD_INTO(Cursor& cursor,
+                                                 BasicRecord<Storage>& record,
+                                                 Classify&& classify) {
         const size_t record_start = cursor.position();
-
-        Field first_field = PARSE_FIELD(cursor, INVALID_INDEX);
-        record.fields.push_back(first_field);
-
-        if (!cursor.done() && cursor.peek() == GS) {
-            cursor.advance();
-        }
-
         size_t record_end = INVALID_INDEX;
-        const size_t declared_length = PARSE_LEN_FROM_FIRST_FIELD(first_field);
-
-        if (declared_length > 0U &&
-            record_start + declared_length <= cursor.size()) {
-            record_end = record_start + declared_length;
-        }
 
         while (!cursor.done() && cursor.peek() != FS) {
-            record.fields.push_back(PARSE_FIELD(cursor, record_end));
+            const size_t index = record.fields.size();
+            auto* field = EMPLACE(record.fields);
+            if (field == nullptr) {
+                return PARSE_CAPACITY_EXCEEDED;
+            }
+            PARSE_TAG_INTO(cursor, *field);
+            const PARSE_STATUS status = PARSE_FIELD_VALUE_INTO(
+                cursor, record_end, classify(index, field->tag), *field);
+            if (status != PARSE_OK) {
+                return status;
+            }
+
+            if (index == 0U) {
+                const size_t declared_length =
+                    PARSE_LEN_FROM_FIRST_FIELD(*field);
+                if (declared_length > 0U &&
+                    record_start + declared_length <= cursor.size()) {
+                    record_end = record_start + declared_length;
+                }
+            }
 
             if (!cursor.done() && cursor.peek() == GS) {
                 cursor.advance();
@@ -288,15 +491,35 @@ namespace nnist {
             }
         }
 
+        return PARSE_OK;
+    }
+
+    template <bool BINARY_FIELDS = true, typename Storage>
+    inline PARSE_STATUS PARSE_RECORD_INTO(Cursor& cursor,
+                                          BasicRecord<Storage>& record) {
+        return PARSE_TAGGED_RECORD_INTO(
+            cursor, record,
+            [](size_t, std::span<const uint8_t> tag) noexcept {
+                return BINARY_FIELDS && TAG_ENDS_WITH(tag, ".999");
+            });
+    }
+
+#if !NNIST_FREESTANDING
+    inline Record PARSE_RECORD(Cursor& cursor) {
+        Record record;
+        PARSE_RECORD_INTO(cursor, record);
         return record;
     }
+#endif
 
     // --------------------------------------------
     // Binary Record Parsing (LEN-Governed)
     // --------------------------------------------
-    inline Record PARSE_BINARY_RECORD_BY_LEN(Cursor& cursor, int record_type) {
+    template <typename Storage>
+    inline PARSE_STATUS PARSE_BINARY_RECORD_INTO(
+        Cursor& cursor, int record_type, BasicRecord<Storage>& record) {
         if (cursor.remaining() < 4U) {
-            throw std::runtime_error("Binary record EOF");
+            return PARSE_BINARY_EOF;
         }
 
         const uint32_t declared_length = READ_BE_U32(
@@ -304,26 +527,72 @@ namespace nnist {
 
         if (declared_length < MIN_BINARY_RECORD_SIZE ||
             declared_length > cursor.remaining()) {
-            throw std::runtime_error("Invalid binary LEN");
+            return PARSE_INVALID_BINARY_LEN;
         }
 
-        Record record;
         record.type = record_type;
         record.is_binary_record = true;
 
         const size_t start_position = cursor.position();
         cursor.advance(declared_length);
 
-        auto bytes =
-            cursor.slice(start_position, start_position + declared_length);
-        record.raw_record.assign(bytes.begin(), bytes.end());
+        record.raw_record = MAKE_BYTES<typename Storage::Bytes>(
+            cursor.slice(start_position, start_position + declared_length));
 
         record.idc = record.raw_record.size() > 4U ? record.raw_record[4U] : -1;
 
+        return PARSE_OK;
+    }
+
+#if !NNIST_FREESTANDING
+    inline Record PARSE_BINARY_RECORD_BY_LEN(Cursor& cursor, int record_type) {
+        Record record;
+        const PARSE_STATUS status =
+            PARSE_BINARY_RECORD_INTO(cursor, record_type, record);
+        if (status != PARSE_OK) {
+            throw std::runtime_error(PARSE_STATUS_MESSAGE(status));
+        }
         return record;
     }
+#endif
 
     // ---- Parse CNT (Type-1 1.003) ----
+    template <typename Storage>
+    inline size_t FIND_CNT_FIELD(const BasicRecord<Storage>& type1) noexcept {
+        for (size_t i = 0; i < type1.fields.size(); i++) {
+            const auto& tag = type1.fields[i].tag;
+            if (TAG_EQUALS(tag, "1.003") || TAG_EQUALS(tag, "1.03")) {
+                return i;
+            }
+        }
+        return INVALID_INDEX;
+    }
+
+    // Reads one [type, IDC] CNT subfield. Subfields with fewer than two
+    // items are not entries and yield false with `valid` still true.
+    template <typename Storage>
+    inline bool READ_CNT_ENTRY(const BasicSubfield<Storage>& subfield,
+                               int& record_type, int& idc,
+                               bool& valid) noexcept {
+        valid = true;
+        if (subfield.items.size() < 2) {
+            return false;
+        }
+
+        size_t type_value = 0U;
+        size_t idc_value = 0U;
+        if (!PARSE_UNSIGNED(subfield.items[0].bytes, type_value) ||
+            !PARSE_UNSIGNED(subfield.items[1].bytes, idc_value)) {
+            valid = false;
+            return false;
+        }
+
+        record_type = static_cast<int>(type_value);
+        idc = static_cast<int>(idc_value);
+        return true;
+    }
+
+#if !NNIST_FREESTANDING
     inline std::vector<std::pair<int, int>> PARSE_CNT_PLAN(
 
         const Record& type1) {
@@ -358,6 +627,7 @@ namespace nnist {
 
         return plan;
     }
+#endif
 
     // --------------------------------------------
     // File Parsing Helpers
@@ -368,8 +638,9 @@ namespace nnist {
         }
     }
 
+    template <typename Storage>
     inline void SYNC_TO_LEN_IF_PRESENT(Cursor& cursor, size_t record_start,
-                                       const Record& record) {
+                                       const BasicRecord<Storage>& record) {
         if (record.fields.empty()) {
             return;
         }
@@ -381,48 +652,323 @@ namespace nnist {
         }
     }
 
+    // Ties `record` to bytes [offset, offset + length) of `buffer`. The
+    // content hash lets IS_CLEAN_RECORD tell those bytes apart from a later
+    // buffer allocated at the same address.
+    template <typename Storage>
+    inline void SET_SOURCE_SPAN(BasicRecord<Storage>& record,
+                                std::span<const uint8_t> buffer,
+                                size_t offset, size_t length) noexcept {
+        record.source_base = buffer.data();
+        record.source_offset = offset;
+        record.source_length = length;
+        record.source_hash = HASH_BYTES(buffer.subspan(offset, length));
+    }
+
+    // Records the source span of a tagged record whose LEN was honoured.
+    template <typename Storage>
+    inline void REMEMBER_SOURCE_SPAN(const Cursor& cursor, size_t record_start,
+                                     BasicRecord<Storage>& record) noexcept {
+        if (record.fields.empty()) {
+            return;
+        }
+        const size_t declared_length =
+            PARSE_LEN_FROM_FIRST_FIELD(record.fields.front());
+        if (declared_length > 0U &&
+            cursor.position() == record_start + declared_length) {
+            SET_SOURCE_SPAN(record, cursor.slice(0U, cursor.size()),
+                            record_start, declared_length);
+        }
+    }
+
+    // --------------------------------------------
+    // Per-Type Record Parsers (Compile-Time Dispatch)
+    // --------------------------------------------
+    constexpr int MAX_DISPATCH_TYPE = 99;
+    constexpr int ANY_RECORD_TYPE = -1;  // fallback for types off the table
+    constexpr size_t IMAGE_FIELD_NUMBER = 999U;
+
+    // parse(cursor, record) tokenizes one record of TYPE at the cursor;
+    // PARSE_RECORD_OF_TYPE does the LEN and source-span bookkeeping around
+    // it, so a parser only parses. The traits are resolved per type at
+    // compile time, so binary types go straight to the LEN-governed reader
+    // with no runtime type switch. Every tagged type keeps the ".999" check
+    // (payloads are accepted in any tagged record); a family that knows a
+    // type is text-only can set HAS_BINARY_FIELDS = false to skip it.
+    // Supply a family (e.g. one deriving from RecordParser, with explicit
+    // specializations for hot or proprietary types) through the first
+    // template argument of PARSE_FILE_INTO.
+    template <int TYPE>
+    struct RecordParser {
+        static constexpr bool IS_BINARY = IS_LEGACY_BINARY_TYPE(TYPE);
+        static constexpr bool HAS_BINARY_FIELDS = !IS_BINARY;
+
+        template <typename Storage>
+        static PARSE_STATUS parse(Cursor& cursor,
+                                  BasicRecord<Storage>& record) {
+            if constexpr (IS_BINARY) {
+                return PARSE_BINARY_RECORD_INTO(cursor, TYPE, record);
+            } else {
+                return PARSE_RECORD_INTO<HAS_BINARY_FIELDS>(cursor, record);
+            }
+        }
+    };
+
+    // Types 2 and 9 carry no image field, so their fields are tokenized
+    // as text without the ".999" check.
+    struct TextRecordParser {
+        static constexpr bool IS_BINARY = false;
+        static constexpr bool HAS_BINARY_FIELDS = false;
+
+        template <typename Storage>
+        static PARSE_STATUS parse(Cursor& cursor,
+                                  BasicRecord<Storage>& record) {
+            return PARSE_RECORD_INTO<false>(cursor, record);
+        }
+    };
+
+    template <>
+    struct RecordParser<RECORD_TYPE_2> : TextRecordParser {};
+    template <>
+    struct RecordParser<RECORD_TYPE_9> : TextRecordParser {};
+
+    // Image types, whose image is field 999. Every field before it is text;
+    // from field 999 the rest of the LEN span is read as the payload.
+    struct ImageRecordParser {
+        static constexpr bool IS_BINARY = false;
+        static constexpr bool HAS_BINARY_FIELDS = true;
+        static constexpr size_t IMAGE_FIELD = IMAGE_FIELD_NUMBER;
+
+        template <typename Storage>
+        static PARSE_STATUS parse(Cursor& cursor,
+                                  BasicRecord<Storage>& record) {
+            return PARSE_TAGGED_RECORD_INTO(
+                cursor, record,
+                [](size_t, std::span<const uint8_t> tag) noexcept {
+                    return TAG_FIELD_NUMBER(tag) == IMAGE_FIELD;
+                });
+        }
+    };
+
+    template <>
+    struct RecordParser<RECORD_TYPE_10> : ImageRecordParser {};
+    template <>
+    struct RecordParser<RECORD_TYPE_13> : ImageRecordParser {};
+    template <>
+    struct RecordParser<RECORD_TYPE_14> : ImageRecordParser {};
+    template <>
+    struct RecordParser<RECORD_TYPE_15> : ImageRecordParser {};
+    template <>
+    struct RecordParser<RECORD_TYPE_17> : ImageRecordParser {};
+
+    // Notes field `index` in `fields` when its tag is a tracked "1.<n>".
+    inline void NOTE_TYPE1_FIELD(Type1Fields& fields, size_t index,
+                                 std::span<const uint8_t> tag) noexcept {
+        if (tag.size() > 2U && tag[0] == static_cast<uint8_t>('1') &&
+            tag[1] == static_cast<uint8_t>('.')) {
+            fields.note(index, TAG_FIELD_NUMBER(tag));
+        }
+    }
+
+    template <typename Storage>
+    inline Type1Fields LOCATE_TYPE1_FIELDS(
+        const BasicRecord<Storage>& type1) noexcept {
+        Type1Fields fields;
+        for (size_t i = 0; i < type1.fields.size(); i++) {
+            NOTE_TYPE1_FIELD(fields, i, type1.fields[i].tag);
+        }
+        return fields;
+    }
+
+    // Type-1 parses straight into Type1Fields; PARSE_FILE_INTO keeps them
+    // in file.type1. Its ".999" check stays, as for any tagged record.
+    template <>
+    struct RecordParser<RECORD_TYPE_1> {
+        static constexpr bool IS_BINARY = false;
+        static constexpr bool HAS_BINARY_FIELDS = true;
+
+        template <typename Storage>
+        static PARSE_STATUS parse(Cursor& cursor,
+                                  BasicRecord<Storage>& record,
+                                  Type1Fields& fields) {
+            fields = Type1Fields{};
+            return PARSE_TAGGED_RECORD_INTO(
+                cursor, record,
+                [&fields](size_t index,
+                          std::span<const uint8_t> tag) noexcept {
+                    NOTE_TYPE1_FIELD(fields, index, tag);
+                    return TAG_ENDS_WITH(tag, ".999");
+                });
+        }
+
+        template <typename Storage>
+        static PARSE_STATUS parse(Cursor& cursor,
+                                  BasicRecord<Storage>& record) {
+            Type1Fields fields;
+            return parse(cursor, record, fields);
+        }
+    };
+
+    // Runs parse(cursor, record) and records the source span: for a
+    // tagged record the cursor is synchronized to its LEN and the LEN span
+    // is kept when honoured; for a binary record, the bytes it consumed.
+    template <typename Storage, typename Parse>
+    inline PARSE_STATUS PARSE_WITH_SOURCE_SPAN(Cursor& cursor,
+                                               BasicRecord<Storage>& record,
+                                               Parse&& parse) {
+        const size_t record_start = cursor.position();
+        const PARSE_STATUS status = parse(cursor, record);
+        if (record.is_binary_record) {
+            SET_SOURCE_SPAN(record, cursor.slice(0U, cursor.size()),
+                            record_start, cursor.position() - record_start);
+        } else {
+            SYNC_TO_LEN_IF_PRESENT(cursor, record_start, record);
+            REMEMBER_SOURCE_SPAN(cursor, record_start, record);
+        }
+        return status;
+    }
+
+    template <typename Storage>
+    using RecordParseFn = PARSE_STATUS (*)(Cursor&, BasicRecord<Storage>&);
+
+    template <template <int> class Parsers, typename Storage, size_t... TYPES>
+    constexpr auto MAKE_PARSER_TABLE(std::index_sequence<TYPES...>) noexcept {
+        return std::array<RecordParseFn<Storage>, sizeof...(TYPES)>{
+            &Parsers<static_cast<int>(TYPES)>::template parse<Storage>...};
+    }
+
+    // One entry per record type 0..MAX_DISPATCH_TYPE.
+    template <template <int> class Parsers, typename Storage>
+    inline constexpr auto RECORD_PARSER_TABLE =
+        MAKE_PARSER_TABLE<Parsers, Storage>(
+            std::make_index_sequence<MAX_DISPATCH_TYPE + 1>{});
+
+    template <template <int> class Parsers = RecordParser, typename Storage>
+    inline PARSE_STATUS PARSE_RECORD_OF_TYPE(Cursor& cursor, int record_type,
+                                             BasicRecord<Storage>& record) {
+        RecordParseFn<Storage> parse =
+            &Parsers<ANY_RECORD_TYPE>::template parse<Storage>;
+        if (record_type >= 0 && record_type <= MAX_DISPATCH_TYPE) {
+            parse = RECORD_PARSER_TABLE<Parsers, Storage>[static_cast<size_t>(
+                record_type)];
+        }
+        return PARSE_WITH_SOURCE_SPAN(cursor, record, parse);
+    }
+
+    // Parses the Type-1 record through the family and fills `fields`,
+    // directly when the family's Type-1 parser takes them, otherwise from
+    // the parsed tags.
+    template <template <int> class Parsers = RecordParser, typename Storage>
+    inline PARSE_STATUS PARSE_TYPE1_INTO(Cursor& cursor,
+                                         BasicRecord<Storage>& record,
+                                         Type1Fields& fields) {
+        using Parser = Parsers<RECORD_TYPE_1>;
+        return PARSE_WITH_SOURCE_SPAN(
+            cursor, record,
+            [&fields](Cursor& at, BasicRecord<Storage>& type1) {
+                if constexpr (requires { Parser::parse(at, type1, fields); }) {
+                    return Parser::parse(at, type1, fields);
+                } else {
+                    const PARSE_STATUS status =
+                        Parser::template parse<Storage>(at, type1);
+                    fields = LOCATE_TYPE1_FIELDS(type1);
+                    return status;
+                }
+            });
+    }
+
     // --------------------------------------------
     // File Parsing (CNT Authoritative)
     // --------------------------------------------
-    inline File PARSE_FILE(const std::vector<uint8_t>& buffer) {
-        Cursor cursor{std::span<const uint8_t>(buffer)};
-        File file;
+    template <template <int> class Parsers = RecordParser, typename Storage>
+    inline PARSE_STATUS PARSE_FILE_INTO(std::span<const uint8_t> buffer,
+                                        BasicFile<Storage>& file) {
+        Cursor cursor{buffer};
+        file.records.clear();
+        file.type1 = Type1Fields{};
 
         // Type-1
-        const size_t type1_start = cursor.position();
-        Record type_one = PARSE_RECORD(cursor);
-        type_one.type = 1;
-        type_one.idc = -1;
-        SYNC_TO_LEN_IF_PRESENT(cursor, type1_start, type_one);
+        auto* type_one = EMPLACE(file.records);
+        if (type_one == nullptr) {
+            return PARSE_CAPACITY_EXCEEDED;
+        }
+        PARSE_STATUS status =
+            PARSE_TYPE1_INTO<Parsers>(cursor, *type_one, file.type1);
+        if (status != PARSE_OK) {
+            return status;
+        }
+        type_one->type = 1;
+        type_one->idc = -1;
         SKIP_SEPARATORS(cursor);
 
-        file.records.push_back(type_one);
+        const size_t cnt_index = file.type1.cnt;
+        if (cnt_index == INVALID_INDEX) {
+            return PARSE_OK;
+        }
 
-        auto plan = PARSE_CNT_PLAN(type_one);
+        // Re-index records[0] on every entry: appending may reallocate.
+        const size_t entry_count =
+            file.records[0].fields[cnt_index].subfields.size();
+
+        for (size_t i = 1; i < entry_count; i++) {
+            int record_type = -1;
+            int idc = -1;
+            bool valid = true;
+            const auto& entry =
+                file.records[0].fields[cnt_index].subfields[i];
+            if (!READ_CNT_ENTRY(entry, record_type, idc, valid)) {
+                if (!valid) {
+                    return PARSE_INVALID_CNT;
+                }
+                continue;
+            }
 
-        for (auto& [record_type, idc] : plan) {
             if (cursor.remaining() < 4U) {
                 break;
             }
 
-            const size_t rec_start = cursor.position();
-            Record record;
+            auto* record = EMPLACE(file.records);
+            if (record == nullptr) {
+                return PARSE_CAPACITY_EXCEEDED;
+            }
 
-            if (IS_LEGACY_BINARY_TYPE(record_type)) {
-                record = PARSE_BINARY_RECORD_BY_LEN(cursor, record_type);
-            } else {
-                record = PARSE_RECORD(cursor);
-                SYNC_TO_LEN_IF_PRESENT(cursor, rec_start, record);
+            status =
+                PARSE_RECORD_OF_TYPE<Parsers>(cursor, record_type, *record);
+            if (status != PARSE_OK) {
+                return status;
             }
 
             SKIP_SEPARATORS(cursor);
 
-            record.type = record_type;
-            record.idc = idc;
-            file.records.push_back(std::move(record));
+            record->type = record_type;
+            record->idc = idc;
         }
 
+        return PARSE_OK;
+    }
+
+    // Field 1.<number> located through file.type1; nullptr when it is
+    // absent or not tracked there.
+    template <typename Storage>
+    inline const BasicField<Storage>* TYPE1_FIELD(
+        const BasicFile<Storage>& file, size_t number) noexcept {
+        const size_t index = file.type1.at(number);
+        if (file.records.empty() || index >= file.records[0].fields.size()) {
+            return nullptr;
+        }
+        return &file.records[0].fields[index];
+    }
+
+#if !NNIST_FREESTANDING
+    inline File PARSE_FILE(const std::vector<uint8_t>& buffer) {
+        File file;
+        const PARSE_STATUS status =
+            PARSE_FILE_INTO(std::span<const uint8_t>(buffer), file);
+        if (status != PARSE_OK) {
+            throw std::runtime_error(PARSE_STATUS_MESSAGE(status));
+        }
         return file;
     }
+#endif
 
 }  // namespace nnist
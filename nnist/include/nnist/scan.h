@@ -0,0 +1,339 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "nnist/constants.h"
+#include "nnist/parsers.h"
+#include "nnist/types.h"
+
+#if !NNIST_FREESTANDING
+#include <vector>
+#endif
+
+namespace nnist {
+
+    // --------------------------------------------
+    // Record Boundaries (Lightweight Scan)
+    // --------------------------------------------
+    struct RecordSpan {
+        int type = -1;
+        int idc = -1;
+        bool is_binary_record = false;
+        size_t offset = 0U;  // first byte of the record in the scanned buffer
+        size_t length = 0U;  // declared LEN (tagged) or 4-byte LEN (binary)
+    };
+
+    constexpr size_t MAX_TAGGED_HEADER_WIDTH = 32U;
+
+    // Reads the "<type>.<001|01>:<LEN>" header at `offset` without
+    // tokenizing the record. Returns false if the bytes there do not look
+    // like a tagged record header.
+    inline bool READ_TAGGED_HEADER(std::span<const uint8_t> buffer,
+                                   size_t offset, int& record_type,
+                                   size_t& length) noexcept {
+        if (offset >= buffer.size()) {
+            return false;
+        }
+
+        const size_t limit =
+            offset + MAX_TAGGED_HEADER_WIDTH < buffer.size()
+                ? offset + MAX_TAGGED_HEADER_WIDTH
+                : buffer.size();
+        const auto window = buffer.subspan(offset, limit - offset);
+
+        size_t position = 0U;
+        size_t type_value = 0U;
+        if (!PARSE_UNSIGNED(window, type_value)) {
+            return false;
+        }
+        while (position < window.size() && window[position] >= '0' &&
+               window[position] <= '9') {
+            ++position;
+        }
+        if (position >= window.size() || window[position] != '.') {
+            return false;
+        }
+        ++position;
+
+        const size_t field_start = position;
+        size_t field_number = 0U;
+        if (!PARSE_UNSIGNED(window.subspan(field_start), field_number) ||
+            field_number != 1U) {
+            return false;
+        }
+        while (position < window.size() && window[position] >= '0' &&
+               window[position] <= '9') {
+            ++position;
+        }
+        if (position - field_start < 2U || position >= window.size() ||
+            window[position] != ':') {
+            return false;
+        }
+        ++position;
+
+        const size_t digits_start = position;
+        if (!PARSE_UNSIGNED(window.subspan(digits_start), length)) {
+            return false;
+        }
+        while (position < window.size() && window[position] >= '0' &&
+               window[position] <= '9') {
+            ++position;
+        }
+        if (position >= window.size() ||
+            (window[position] != GS && window[position] != FS)) {
+            return false;
+        }
+
+        record_type = static_cast<int>(type_value);
+        return length > position;
+    }
+
+    // Offset of the first `first` or `second` byte in [from, buffer end),
+    // or the buffer size when neither occurs.
+    inline size_t FIND_DELIMITER(std::span<const uint8_t> buffer, size_t from,
+                                 uint8_t first, uint8_t second) noexcept {
+        while (from < buffer.size() && buffer[from] != first &&
+               buffer[from] != second) {
+            ++from;
+        }
+        return from;
+    }
+
+    // Calls fn(record_type, idc) for every [type, IDC] entry of the Type-1
+    // CNT field (1.003 / 1.03), reading straight from the record bytes.
+    // Stops early when fn returns false.
+    template <typename Fn>
+    inline PARSE_STATUS FOR_EACH_CNT_ENTRY(std::span<const uint8_t> type1,
+                                           Fn&& fn) {
+        size_t position = 0U;
+
+        while (position < type1.size()) {
+            const size_t field_end = FIND_DELIMITER(type1, position, GS, FS);
+            const auto field = type1.subspan(position, field_end - position);
+            const size_t colon = FIND_DELIMITER(field, 0U, ':', ':');
+            position = field_end + 1U;
+
+            const auto tag = field.first(colon);
+            if (colon == field.size() ||
+                (!TAG_EQUALS(tag, "1.003") && !TAG_EQUALS(tag, "1.03"))) {
+                continue;
+            }
+
+            // First subfield is the record count; entries follow.
+            const auto value = field.subspan(colon + 1U);
+            size_t entry = FIND_DELIMITER(value, 0U, RS, RS);
+
+            while (entry < value.size()) {
+                ++entry;  // RS
+                const size_t entry_end = FIND_DELIMITER(value, entry, RS, RS);
+                const size_t unit = FIND_DELIMITER(value, entry, US, RS);
+
+                if (unit < entry_end) {
+                    size_t record_type = 0U;
+                    size_t idc = 0U;
+                    if (!PARSE_UNSIGNED(value.subspan(entry), record_type) ||
+                        !PARSE_UNSIGNED(value.subspan(unit + 1U), idc)) {
+                        return PARSE_INVALID_CNT;
+                    }
+                    if (!fn(static_cast<int>(record_type),
+                            static_cast<int>(idc))) {
+                        return PARSE_OK;
+                    }
+                }
+                entry = entry_end;
+            }
+            return PARSE_OK;
+        }
+
+        return PARSE_OK;
+    }
+
+    // --------------------------------------------
+    // Tagged Field Walk (No Tokenization)
+    // --------------------------------------------
+    struct TaggedField {
+        int record_type = -1;
+        size_t field_number = 0U;
+        size_t offset = 0U;  // tag start, relative to the record bytes
+        std::span<const uint8_t> tag;
+        std::span<const uint8_t> value;  // raw bytes between ':' and GS/FS
+        bool is_binary_field = false;
+    };
+
+    // Splits "<type>.<field>" into its numbers.
+    inline bool PARSE_FIELD_TAG(std::span<const uint8_t> tag, int& record_type,
+                                size_t& field_number) noexcept {
+        const size_t dot = FIND_DELIMITER(tag, 0U, '.', '.');
+        size_t type_value = 0U;
+        if (dot == 0U || dot + 1U >= tag.size() ||
+            !PARSE_UNSIGNED(tag.first(dot), type_value) ||
+            !PARSE_UNSIGNED(tag.subspan(dot + 1U), field_number)) {
+            return false;
+        }
+        for (const uint8_t digit : tag) {
+            if (digit != '.' && (digit < '0' || digit > '9')) {
+                return false;
+            }
+        }
+        record_type = static_cast<int>(type_value);
+        return true;
+    }
+
+    // Calls fn(const TaggedField&) for each field of one tagged record (the
+    // exact LEN span), splitting only on GS/FS. A ".999" field runs to the
+    // end of the record, as in PARSE_BINARY_FIELD. Stops when fn returns
+    // false.
+    template <typename Fn>
+    inline PARSE_STATUS FOR_EACH_TAGGED_FIELD(std::span<const uint8_t> record,
+                                              Fn&& fn) {
+        size_t position = 0U;
+
+        while (position < record.size() && record[position] != FS) {
+            TaggedField field;
+            field.offset = position;
+
+            const size_t colon = FIND_DELIMITER(record, position, ':', GS);
+            if (colon >= record.size() || record[colon] != ':') {
+                return PARSE_INVALID_FIELD_TAG;
+            }
+            field.tag = record.subspan(position, colon - position);
+            if (!PARSE_FIELD_TAG(field.tag, field.record_type,
+                                 field.field_number)) {
+                return PARSE_INVALID_FIELD_TAG;
+            }
+
+            size_t value_end = 0U;
+            if (TAG_ENDS_WITH(field.tag, ".999")) {
+                field.is_binary_field = true;
+                value_end = record.size();
+                if (value_end > colon + 1U && record[value_end - 1U] == FS) {
+                    --value_end;
+                }
+                if (value_end > colon + 1U && record[value_end - 1U] == GS) {
+                    --value_end;
+                }
+            } else {
+                value_end = FIND_DELIMITER(record, colon + 1U, GS, FS);
+            }
+            field.value = record.subspan(colon + 1U, value_end - colon - 1U);
+
+            if (!fn(static_cast<const TaggedField&>(field))) {
+                return PARSE_OK;
+            }
+            if (field.is_binary_field) {
+                break;
+            }
+            position = value_end;
+            if (position < record.size() && record[position] == GS) {
+                ++position;
+            }
+        }
+
+        return PARSE_OK;
+    }
+
+    inline size_t SKIP_SEPARATORS(std::span<const uint8_t> buffer,
+                                  size_t offset) noexcept {
+        while (offset < buffer.size() &&
+               (buffer[offset] == FS || buffer[offset] == GS)) {
+            ++offset;
+        }
+        return offset;
+    }
+
+    // Walks one transaction starting at `offset` by LEN hops: the Type-1
+    // LEN, its CNT plan, then each record's tagged or binary LEN. Only the
+    // Type-1 CNT field is read; record content is never tokenized.
+    // sink(const RecordSpan&) is called per record (Type-1 first) and may
+    // return false to stop. `end_offset` receives the offset just past the
+    // transaction (including trailing separators, as PARSE_FILE skips them).
+    template <typename Sink>
+    inline PARSE_STATUS SCAN_RECORDS(std::span<const uint8_t> buffer,
+                                     size_t offset, Sink&& sink,
+                                     size_t& end_offset) {
+        end_offset = offset;
+
+        RecordSpan type1;
+        if (!READ_TAGGED_HEADER(buffer, offset, type1.type, type1.length) ||
+            type1.type != RECORD_TYPE_1) {
+            return PARSE_INVALID_TAGGED_LEN;
+        }
+        if (type1.length > buffer.size() - offset) {
+            return PARSE_TRUNCATED;
+        }
+        type1.offset = offset;
+        if (!sink(static_cast<const RecordSpan&>(type1))) {
+            end_offset = offset + type1.length;
+            return PARSE_OK;
+        }
+
+        size_t position = SKIP_SEPARATORS(buffer, offset + type1.length);
+        PARSE_STATUS record_status = PARSE_OK;
+
+        const PARSE_STATUS cnt_status = FOR_EACH_CNT_ENTRY(
+            buffer.subspan(offset, type1.length),
+            [&](int record_type, int idc) {
+                RecordSpan record;
+                record.type = record_type;
+                record.idc = idc;
+                record.offset = position;
+
+                if (buffer.size() - position < 4U) {
+                    record_status = PARSE_TRUNCATED;
+                    return false;
+                }
+
+                if (IS_LEGACY_BINARY_TYPE(record_type)) {
+                    record.is_binary_record = true;
+                    record.length = READ_BE_U32(buffer.subspan(position, 4U));
+                    if (record.length < MIN_BINARY_RECORD_SIZE ||
+                        record.length > buffer.size() - position) {
+                        record_status = PARSE_INVALID_BINARY_LEN;
+                        return false;
+                    }
+                } else {
+                    int tagged_type = -1;
+                    if (!READ_TAGGED_HEADER(buffer, position, tagged_type,
+                                            record.length)) {
+                        record_status = PARSE_INVALID_TAGGED_LEN;
+                        return false;
+                    }
+                    if (record.length > buffer.size() - position) {
+                        record_status = PARSE_TRUNCATED;
+                        return false;
+                    }
+                }
+
+                position = SKIP_SEPARATORS(buffer, position + record.length);
+                return static_cast<bool>(
+                    sink(static_cast<const RecordSpan&>(record)));
+            });
+
+        end_offset = position;
+        if (cnt_status != PARSE_OK) {
+            return cnt_status;
+        }
+        return record_status;
+    }
+
+#if !NNIST_FREESTANDING
+    inline std::vector<RecordSpan> SCAN_TRANSACTION(
+        std::span<const uint8_t> buffer, size_t offset = 0U) {
+        std::vector<RecordSpan> spans;
+        size_t end_offset = 0U;
+        const PARSE_STATUS status = SCAN_RECORDS(
+            buffer, offset,
+            [&](const RecordSpan& span) {
+                spans.push_back(span);
+                return true;
+            },
+            end_offset);
+        if (status != PARSE_OK) {
+            throw std::runtime_error(PARSE_STATUS_MESSAGE(status));
+        }
+        return spans;
+    }
+#endif
+
+}  // namespace nnist
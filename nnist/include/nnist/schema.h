@@ -0,0 +1,561 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "nnist/constants.h"
+#include "nnist/parsers.h"
+#include "nnist/scan.h"
+#include "nnist/types.h"
+
+#if !NNIST_FREESTANDING
+#include <vector>
+#endif
+
+namespace nnist {
+
+    // --------------------------------------------
+    // Field Schema
+    // --------------------------------------------
+    // Character classes of the ANSI/NIST-ITL / EBTS field tables.
+    enum CHAR_CLASS : uint8_t {
+        CHARS_N = 1U,                 // numeric
+        CHARS_A = 2U,                 // alphabetic
+        CHARS_AN = CHARS_N | CHARS_A,  // alphanumeric
+        CHARS_S = 4U,                 // printable special (incl. space)
+        CHARS_NS = CHARS_N | CHARS_S,
+        CHARS_ANS = CHARS_AN | CHARS_S,
+        CHARS_B = 8U  // binary; content is not checked
+    };
+
+    // One field of a record type. Lengths apply to every item; occurrences
+    // count subfields. A zero maximum is unbounded.
+    struct FieldRule {
+        uint16_t field_number = 0U;
+        bool mandatory = false;
+        CHAR_CLASS chars = CHARS_ANS;
+        uint16_t min_length = 0U;
+        uint16_t max_length = 0U;
+        uint16_t min_occurrences = 1U;
+        uint16_t max_occurrences = 1U;
+    };
+
+    constexpr size_t MAX_SCHEMA_RULES = 64U;  // one bit each while validating
+    constexpr uint32_t SCHEMA_HASH_SEED = 0x9E3779B1U;
+    constexpr uint32_t SCHEMA_HASH_STEP_MUL = 1664525U;  // LCG step between
+    constexpr uint32_t SCHEMA_HASH_STEP_ADD = 1013904223U;  // candidates
+    constexpr uint32_t SCHEMA_HASH_TRIES = 1U << 12U;
+    constexpr uint8_t EMPTY_SLOT = 0xFFU;
+
+    // Type-erased view of a RecordSchema, so tables of any size share one
+    // validator.
+    struct SchemaView {
+        int record_type = -1;
+        std::span<const FieldRule> rules;
+        std::span<const uint8_t> slots;
+        uint32_t multiplier = 0U;
+        uint32_t shift = 0U;
+
+        [[nodiscard]] constexpr const FieldRule* find(
+            size_t field_number) const noexcept {
+            if (slots.empty()) {
+                return nullptr;
+            }
+            const uint8_t rule = slots[static_cast<uint32_t>(
+                static_cast<uint32_t>(field_number) * multiplier) >> shift];
+            return rule != EMPTY_SLOT &&
+                           rules[rule].field_number == field_number
+                       ? &rules[rule]
+                       : nullptr;
+        }
+    };
+
+    // Rules of one record type, perfect-hashed on field number at compile
+    // time: slot = (field * multiplier) >> shift, searched until every rule
+    // lands in its own slot. multiplier stays 0 if no such hash was found.
+    template <size_t N>
+    struct RecordSchema {
+        static_assert(N > 0U && N <= MAX_SCHEMA_RULES);
+        static constexpr uint32_t SLOT_BITS = [] {
+            uint32_t bits = 1U;
+            while ((size_t{1} << bits) < 2U * N) {
+                ++bits;
+            }
+            return bits;
+        }();
+        static constexpr size_t SLOT_COUNT = size_t{1} << SLOT_BITS;
+
+        int record_type = -1;
+        std::array<FieldRule, N> rules{};
+        std::array<uint8_t, SLOT_COUNT> slots{};
+        uint32_t multiplier = 0U;
+
+        [[nodiscard]] constexpr SchemaView view() const noexcept {
+            return {record_type, rules, slots, multiplier,
+                    32U - SLOT_BITS};
+        }
+    };
+
+    template <size_t N>
+    consteval RecordSchema<N> MAKE_SCHEMA(int record_type,
+                                          const FieldRule (&rules)[N]) {
+        RecordSchema<N> schema;
+        schema.record_type = record_type;
+        for (size_t i = 0; i < N; i++) {
+            schema.rules[i] = rules[i];
+        }
+
+        constexpr uint32_t SHIFT = 32U - RecordSchema<N>::SLOT_BITS;
+        uint32_t multiplier = SCHEMA_HASH_SEED;
+        for (uint32_t attempt = 0; attempt < SCHEMA_HASH_TRIES; attempt++) {
+            schema.slots.fill(EMPTY_SLOT);
+            bool collision = false;
+            for (size_t i = 0; i < N && !collision; i++) {
+                const uint32_t slot =
+                    (static_cast<uint32_t>(rules[i].field_number) *
+                     multiplier) >>
+                    SHIFT;
+                collision = schema.slots[slot] != EMPTY_SLOT;
+                schema.slots[slot] = static_cast<uint8_t>(i);
+            }
+            if (!collision) {
+                schema.multiplier = multiplier;
+                return schema;
+            }
+            multiplier = (multiplier * SCHEMA_HASH_STEP_MUL +
+                          SCHEMA_HASH_STEP_ADD) |
+                         1U;
+        }
+        return schema;
+    }
+
+    // ---- Built-in tables (ANSI/NIST-ITL 1-2011 base definitions) ----
+    constexpr FieldRule TYPE1_RULES[] = {
+        {1, true, CHARS_N, 1, 8, 1, 1},      // LEN
+        {2, true, CHARS_N, 4, 4, 1, 1},      // VER
+        {3, true, CHARS_N, 1, 3, 2, 0},      // CNT
+        {4, true, CHARS_AN, 1, 16, 1, 1},    // TOT
+        {5, true, CHARS_N, 8, 8, 1, 1},      // DAT
+        {6, false, CHARS_N, 1, 1, 1, 1},     // PRY
+        {7, true, CHARS_ANS, 1, 35, 1, 1},   // DAI
+        {8, true, CHARS_ANS, 1, 35, 1, 1},   // ORI
+        {9, true, CHARS_ANS, 1, 40, 1, 1},   // TCN
+        {10, false, CHARS_ANS, 1, 40, 1, 1},  // TCR
+        {11, true, CHARS_NS, 4, 5, 1, 1},    // NSR
+        {12, true, CHARS_NS, 4, 5, 1, 1},    // NTR
+        {13, false, CHARS_ANS, 1, 40, 1, 1},  // DOM
+        {14, false, CHARS_ANS, 15, 15, 1, 1},  // GMT
+        {15, false, CHARS_ANS, 1, 40, 1, 0},  // DCS
+    };
+    constexpr FieldRule TYPE2_RULES[] = {
+        {1, true, CHARS_N, 1, 8, 1, 1},  // LEN
+        {2, true, CHARS_N, 1, 2, 1, 1},  // IDC
+    };
+    constexpr FieldRule TYPE9_RULES[] = {
+        {1, true, CHARS_N, 1, 8, 1, 1},       // LEN
+        {2, true, CHARS_N, 1, 2, 1, 1},       // IDC
+        {3, true, CHARS_N, 1, 2, 1, 1},       // IMP
+        {4, true, CHARS_A, 1, 1, 1, 1},       // FMT
+        {5, false, CHARS_ANS, 1, 40, 1, 0},   // OFR
+        {6, false, CHARS_N, 1, 2, 1, 6},      // FGP
+        {7, false, CHARS_AN, 1, 3, 1, 0},     // FPC
+        {8, false, CHARS_N, 8, 8, 1, 1},      // CRP
+        {9, false, CHARS_N, 8, 8, 1, 0},      // DLT
+        {10, false, CHARS_N, 1, 3, 1, 1},     // NMN
+        {11, false, CHARS_N, 1, 1, 1, 1},     // MRC
+        {12, false, CHARS_ANS, 1, 13, 1, 0},  // MIN
+    };
+    constexpr FieldRule TYPE10_RULES[] = {
+        {1, true, CHARS_N, 1, 8, 1, 1},      // LEN
+        {2, true, CHARS_N, 1, 2, 1, 1},      // IDC
+        {3, true, CHARS_A, 4, 11, 1, 1},     // IMT
+        {4, true, CHARS_ANS, 1, 35, 1, 1},   // SRC
+        {5, true, CHARS_N, 8, 8, 1, 1},      // PHD
+        {6, true, CHARS_N, 2, 5, 1, 1},      // HLL
+        {7, true, CHARS_N, 2, 5, 1, 1},      // VLL
+        {8, true, CHARS_N, 1, 1, 1, 1},      // SLC
+        {9, true, CHARS_N, 1, 5, 1, 1},      // THPS
+        {10, true, CHARS_N, 1, 5, 1, 1},     // TVPS
+        {11, true, CHARS_AN, 3, 5, 1, 1},    // CGA
+        {12, true, CHARS_AN, 3, 4, 1, 1},    // CSP
+        {999, true, CHARS_B, 1, 0, 1, 1},    // DATA
+    };
+    constexpr FieldRule TYPE14_RULES[] = {
+        {1, true, CHARS_N, 1, 8, 1, 1},      // LEN
+        {2, true, CHARS_N, 1, 2, 1, 1},      // IDC
+        {3, true, CHARS_N, 1, 2, 1, 1},      // IMP
+        {4, true, CHARS_ANS, 1, 35, 1, 1},   // SRC
+        {5, true, CHARS_N, 8, 8, 1, 1},      // FCD
+        {6, true, CHARS_N, 2, 5, 1, 1},      // HLL
+        {7, true, CHARS_N, 2, 5, 1, 1},      // VLL
+        {8, true, CHARS_N, 1, 1, 1, 1},      // SLC
+        {9, true, CHARS_N, 1, 5, 1, 1},      // THPS
+        {10, true, CHARS_N, 1, 5, 1, 1},     // TVPS
+        {11, true, CHARS_AN, 3, 5, 1, 1},    // CGA
+        {12, true, CHARS_N, 1, 2, 1, 1},     // BPX
+        {13, true, CHARS_N, 1, 2, 1, 6},     // FGP
+        {999, true, CHARS_B, 1, 0, 1, 1},    // DATA
+    };
+
+    constexpr auto TYPE1_SCHEMA = MAKE_SCHEMA(RECORD_TYPE_1, TYPE1_RULES);
+    constexpr auto TYPE2_SCHEMA = MAKE_SCHEMA(RECORD_TYPE_2, TYPE2_RULES);
+    constexpr auto TYPE9_SCHEMA = MAKE_SCHEMA(RECORD_TYPE_9, TYPE9_RULES);
+    constexpr auto TYPE10_SCHEMA = MAKE_SCHEMA(RECORD_TYPE_10, TYPE10_RULES);
+    constexpr auto TYPE14_SCHEMA = MAKE_SCHEMA(RECORD_TYPE_14, TYPE14_RULES);
+    static_assert(TYPE1_SCHEMA.multiplier != 0U &&
+                      TYPE2_SCHEMA.multiplier != 0U &&
+                      TYPE9_SCHEMA.multiplier != 0U &&
+                      TYPE10_SCHEMA.multiplier != 0U &&
+                      TYPE14_SCHEMA.multiplier != 0U,
+                  "no collision-free field hash");
+
+    // Schema for a record type; an empty view (no rules) when none is
+    // defined, which validates everything.
+    constexpr SchemaView FIND_SCHEMA(int record_type) noexcept {
+        switch (record_type) {
+            case RECORD_TYPE_1:
+                return TYPE1_SCHEMA.view();
+            case RECORD_TYPE_2:
+                return TYPE2_SCHEMA.view();
+            case RECORD_TYPE_9:
+                return TYPE9_SCHEMA.view();
+            case RECORD_TYPE_10:
+                return TYPE10_SCHEMA.view();
+            case RECORD_TYPE_14:
+                return TYPE14_SCHEMA.view();
+            default:
+                return {};
+        }
+    }
+
+    // --------------------------------------------
+    // Schema Validation
+    // --------------------------------------------
+    enum SCHEMA_ERROR : uint8_t {
+        SCHEMA_MISSING_FIELD = 0,
+        SCHEMA_DUPLICATE_FIELD,
+        SCHEMA_BAD_CHARACTER,
+        SCHEMA_TOO_SHORT,
+        SCHEMA_TOO_LONG,
+        SCHEMA_TOO_FEW_OCCURRENCES,
+        SCHEMA_TOO_MANY_OCCURRENCES,
+        SCHEMA_MALFORMED_RECORD
+    };
+
+    struct SchemaViolation {
+        SCHEMA_ERROR error = SCHEMA_MALFORMED_RECORD;
+        int record_type = -1;
+        size_t field_number = 0U;
+        size_t offset = 0U;  // offending byte (or field / record start)
+    };
+
+    constexpr uint8_t PRINTABLE_FIRST = 0x20U;
+    constexpr uint8_t PRINTABLE_LAST = 0x7EU;
+
+    // CHAR_CLASS bit of one byte. Bytes above 0x7F count as special so
+    // Latin-1/UTF-8 text (per DCS) is accepted wherever ANS is.
+    constexpr uint8_t CHAR_CLASS_OF(uint8_t byte) noexcept {
+        if (byte >= '0' && byte <= '9') {
+            return CHARS_N;
+        }
+        if ((byte >= 'A' && byte <= 'Z') || (byte >= 'a' && byte <= 'z')) {
+            return CHARS_A;
+        }
+        if ((byte >= PRINTABLE_FIRST && byte <= PRINTABLE_LAST) ||
+            byte > PRINTABLE_LAST + 1U) {
+            return CHARS_S;
+        }
+        return 0U;
+    }
+
+    constexpr auto CHAR_CLASS_TABLE = [] {
+        std::array<uint8_t, 256> table{};
+        for (size_t i = 0; i < table.size(); i++) {
+            table[i] = CHAR_CLASS_OF(static_cast<uint8_t>(i));
+        }
+        return table;
+    }();
+
+    // Walks the items of one field value, checking each against `rule`.
+    // `base` is the absolute offset of value[0]. Returns false when the
+    // sink asked to stop.
+    template <typename Sink>
+    inline bool CHECK_FIELD_VALUE(const FieldRule& rule, int record_type,
+                                  std::span<const uint8_t> value, size_t base,
+                                  Sink& sink, size_t& violations) {
+        const auto report = [&](SCHEMA_ERROR error, size_t offset) {
+            ++violations;
+            return static_cast<bool>(sink(static_cast<const SchemaViolation&>(
+                SchemaViolation{error, record_type, rule.field_number,
+                                offset})));
+        };
+
+        if (rule.chars == CHARS_B) {
+            return value.size() >= rule.min_length ||
+                   report(SCHEMA_TOO_SHORT, base);
+        }
+
+        size_t occurrences = 1U;
+        size_t item_start = 0U;
+        for (size_t i = 0; i <= value.size(); i++) {
+            const bool at_end = i == value.size();
+            const uint8_t byte = at_end ? uint8_t{US} : value[i];
+            if (!at_end && byte != US && byte != RS) {
+                if ((CHAR_CLASS_TABLE[byte] & rule.chars) == 0U &&
+                    !report(SCHEMA_BAD_CHARACTER, base + i)) {
+                    return false;
+                }
+                continue;
+            }
+
+            const size_t length = i - item_start;
+            if (length < rule.min_length &&
+                !report(SCHEMA_TOO_SHORT, base + item_start)) {
+                return false;
+            }
+            if (rule.max_length != 0U && length > rule.max_length &&
+                !report(SCHEMA_TOO_LONG, base + item_start)) {
+                return false;
+            }
+            item_start = i + 1U;
+            occurrences += byte == RS ? 1U : 0U;
+        }
+
+        if (occurrences < rule.min_occurrences &&
+            !report(SCHEMA_TOO_FEW_OCCURRENCES, base)) {
+            return false;
+        }
+        return rule.max_occurrences == 0U ||
+               occurrences <= rule.max_occurrences ||
+               report(SCHEMA_TOO_MANY_OCCURRENCES, base);
+    }
+
+    // Reports every mandatory rule whose bit is not set in `seen`.
+    template <typename Sink>
+    inline void REPORT_MISSING_FIELDS(const SchemaView& schema, uint64_t seen,
+                                      size_t base, Sink& sink,
+                                      size_t& violations) {
+        for (size_t i = 0; i < schema.rules.size(); i++) {
+            if (!schema.rules[i].mandatory ||
+                (seen & (uint64_t{1} << i)) != 0U) {
+                continue;
+            }
+            ++violations;
+            if (!sink(static_cast<const SchemaViolation&>(SchemaViolation{
+                    SCHEMA_MISSING_FIELD, schema.record_type,
+                    schema.rules[i].field_number, base}))) {
+                return;
+            }
+        }
+    }
+
+    // Validates one raw tagged record (its exact LEN span) in a single pass
+    // and calls sink(const SchemaViolation&) for each violation; the sink
+    // may return false to stop. `base` is the record's offset in the
+    // transaction, so reported offsets are absolute. Fields without a rule
+    // (user-defined or unknown) are accepted. Never allocates.
+    template <typename Sink>
+    inline size_t VALIDATE_RECORD_SCHEMA(std::span<const uint8_t> record,
+                                         const SchemaView& schema, Sink&& sink,
+                                         size_t base = 0U) {
+        size_t violations = 0U;
+        uint64_t seen = 0U;
+        bool stopped = false;
+
+        const PARSE_STATUS status =
+            FOR_EACH_TAGGED_FIELD(record, [&](const TaggedField& field) {
+                const FieldRule* rule = schema.find(field.field_number);
+                if (rule == nullptr) {
+                    return true;
+                }
+                const uint64_t bit = uint64_t{1}
+                                     << static_cast<size_t>(
+                                            rule - schema.rules.data());
+                if ((seen & bit) != 0U) {
+                    ++violations;
+                    stopped = !sink(static_cast<const SchemaViolation&>(
+                        SchemaViolation{SCHEMA_DUPLICATE_FIELD,
+                                        schema.record_type,
+                                        field.field_number,
+                                        base + field.offset}));
+                    return !stopped;
+                }
+                seen |= bit;
+
+                const size_t value_offset =
+                    base + field.offset + field.tag.size() + 1U;
+                stopped = !CHECK_FIELD_VALUE(*rule, schema.record_type,
+                                             field.value, value_offset, sink,
+                                             violations);
+                return !stopped;
+            });
+
+        if (stopped) {
+            return violations;
+        }
+        if (status != PARSE_OK) {
+            ++violations;
+            sink(static_cast<const SchemaViolation&>(SchemaViolation{
+                SCHEMA_MALFORMED_RECORD, schema.record_type, 0U, base}));
+            return violations;
+        }
+
+        REPORT_MISSING_FIELDS(schema, seen, base, sink, violations);
+        return violations;
+    }
+
+    // Validates every tagged record of a transaction located by LEN hops
+    // (binary Type-3..8 records have no tagged schema and are skipped).
+    template <typename Sink>
+    inline size_t VALIDATE_TRANSACTION_SCHEMA(std::span<const uint8_t> buffer,
+                                              Sink&& sink) {
+        size_t violations = 0U;
+        bool stopped = false;
+        const auto forward = [&](const SchemaViolation& violation) {
+            stopped = !sink(violation);
+            return !stopped;
+        };
+
+        size_t end_offset = 0U;
+        const PARSE_STATUS status = SCAN_RECORDS(
+            buffer, 0U,
+            [&](const RecordSpan& span) {
+                if (!span.is_binary_record) {
+                    violations += VALIDATE_RECORD_SCHEMA(
+                        buffer.subspan(span.offset, span.length),
+                        FIND_SCHEMA(span.type), forward, span.offset);
+                }
+                return !stopped;
+            },
+            end_offset);
+
+        if (status != PARSE_OK && !stopped) {
+            ++violations;
+            sink(static_cast<const SchemaViolation&>(SchemaViolation{
+                SCHEMA_MALFORMED_RECORD, -1, 0U, end_offset}));
+        }
+        return violations;
+    }
+
+    // Same checks over an already parsed record. Offsets are reconstructed
+    // from the field sizes and are absolute when the record remembers its
+    // source span, record-relative otherwise.
+    template <typename Storage, typename Sink>
+    inline size_t VALIDATE_RECORD_SCHEMA(const BasicRecord<Storage>& record,
+                                         Sink&& sink) {
+        const SchemaView schema = FIND_SCHEMA(record.type);
+        size_t violations = 0U;
+        uint64_t seen = 0U;
+        size_t offset =
+            record.source_offset == INVALID_INDEX ? 0U : record.source_offset;
+        const size_t base = offset;
+
+        for (const auto& field : record.fields) {
+            int record_type = -1;
+            size_t field_number = 0U;
+            const auto tag =
+                std::span<const uint8_t>(field.tag.data(), field.tag.size());
+            const size_t field_offset = offset;
+
+            // Value size as serialized: items joined by US, subfields by RS.
+            size_t value_size = 0U;
+            if (field.is_binary_field) {
+                value_size = field.raw_field.size();
+            } else {
+                for (size_t s = 0; s < field.subfields.size(); s++) {
+                    const auto& items = field.subfields[s].items;
+                    value_size += s > 0U ? 1U : 0U;
+                    for (size_t i = 0; i < items.size(); i++) {
+                        value_size +=
+                            items[i].bytes.size() + (i > 0U ? 1U : 0U);
+                    }
+                }
+            }
+            offset += tag.size() + 1U + value_size + 1U;
+
+            if (!PARSE_FIELD_TAG(tag, record_type, field_number)) {
+                continue;
+            }
+            const FieldRule* rule = schema.find(field_number);
+            if (rule == nullptr) {
+                continue;
+            }
+            const uint64_t bit =
+                uint64_t{1} << static_cast<size_t>(rule - schema.rules.data());
+            if ((seen & bit) != 0U) {
+                ++violations;
+                if (!sink(static_cast<const SchemaViolation&>(SchemaViolation{
+                        SCHEMA_DUPLICATE_FIELD, schema.record_type,
+                        field_number, field_offset}))) {
+                    return violations;
+                }
+                continue;
+            }
+            seen |= bit;
+
+            const size_t value_offset = field_offset + tag.size() + 1U;
+            if (field.is_binary_field) {
+                if (!CHECK_FIELD_VALUE(*rule, schema.record_type,
+                                       std::span<const uint8_t>(
+                                           field.raw_field.data(),
+                                           field.raw_field.size()),
+                                       value_offset, sink, violations)) {
+                    return violations;
+                }
+                continue;
+            }
+
+            // Items are checked in place; the separators between them are
+            // implied by position.
+            size_t item_offset = value_offset;
+            for (size_t s = 0; s < field.subfields.size(); s++) {
+                for (const auto& item : field.subfields[s].items) {
+                    const FieldRule single{rule->field_number, false,
+                                           rule->chars, rule->min_length,
+                                           rule->max_length, 0U, 0U};
+                    if (!CHECK_FIELD_VALUE(single, schema.record_type,
+                                           std::span<const uint8_t>(
+                                               item.bytes.data(),
+                                               item.bytes.size()),
+                                           item_offset, sink, violations)) {
+                        return violations;
+                    }
+                    item_offset += item.bytes.size() + 1U;
+                }
+            }
+            const size_t occurrences = field.subfields.size();
+            SCHEMA_ERROR error = SCHEMA_MISSING_FIELD;
+            if (occurrences < rule->min_occurrences) {
+                error = SCHEMA_TOO_FEW_OCCURRENCES;
+            } else if (rule->max_occurrences != 0U &&
+                       occurrences > rule->max_occurrences) {
+                error = SCHEMA_TOO_MANY_OCCURRENCES;
+            }
+            if (error != SCHEMA_MISSING_FIELD) {
+                ++violations;
+                if (!sink(static_cast<const SchemaViolation&>(SchemaViolation{
+                        error, schema.record_type, field_number,
+                        value_offset}))) {
+                    return violations;
+                }
+            }
+        }
+
+        REPORT_MISSING_FIELDS(schema, seen, base, sink, violations);
+        return violations;
+    }
+
+#if !NNIST_FREESTANDING
+    inline std::vector<SchemaViolation> VALIDATE_SCHEMA(
+        std::span<const uint8_t> buffer) {
+        std::vector<SchemaViolation> violations;
+        VALIDATE_TRANSACTION_SCHEMA(buffer,
+                                    [&](const SchemaViolation& violation) {
+                                        violations.push_back(violation);
+                                        return true;
+                                    });
+        return violations;
+    }
+#endif
+
+}  // namespace nnist
@@ -1,12 +1,19 @@
 #pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <filesystem>
 #include <fstream>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "nnist/hash.h"
 #include "nnist/parsers.h"
 #include "nnist/types.h"
 namespace nnist {
@@ -62,6 +69,87 @@ namespace nnist {
         out.push_back(FS);  // Every tagged record ends with FS
     }
 
+    // ---- Exact Sizes / Direct Writes (No Temporary Buffers) ----
+    inline size_t SERIALIZED_SUBFIELD_SIZE(const Subfield& subfield,
+                                           bool end = false) noexcept {
+        size_t size = end ? 0U : 1U;  // RS
+        for (const auto& item : subfield.items) {
+            size += item.bytes.size() + 1U;  // US
+        }
+        return subfield.items.empty() ? size : size - 1U;
+    }
+
+    inline size_t SERIALIZED_FIELD_SIZE(const Field& field,
+                                        bool end = false) noexcept {
+        size_t size = field.tag.size() + 1U;  // ':'
+        if (field.is_binary_field) {
+            return size + field.raw_field.size();
+        }
+        for (size_t i = 0; i < field.subfields.size(); i++) {
+            size += SERIALIZED_SUBFIELD_SIZE(field.subfields[i],
+                                             i + 1 == field.subfields.size());
+        }
+        return end ? size : size + 1U;  // GS
+    }
+
+    // Size SERIALIZE_RECORD would append for `rec`.
+    inline size_t SERIALIZED_RECORD_SIZE(const Record& rec) noexcept {
+        if (rec.is_binary_record) {
+            return rec.raw_record.size();
+        }
+        size_t size = 1U;  // FS
+        for (size_t i = 0; i < rec.fields.size(); i++) {
+            size += SERIALIZED_FIELD_SIZE(rec.fields[i],
+                                          i + 1 == rec.fields.size());
+        }
+        return size;
+    }
+
+    inline uint8_t* WRITE_BYTES(uint8_t* out,
+                                const std::vector<uint8_t>& bytes) noexcept {
+        if (!bytes.empty()) {
+            std::memcpy(out, bytes.data(), bytes.size());
+        }
+        return out + bytes.size();
+    }
+
+    // Writes exactly the bytes SERIALIZE_RECORD would append into `out`,
+    // which must hold SERIALIZED_RECORD_SIZE(rec) bytes. Returns the end.
+    inline uint8_t* WRITE_RECORD(uint8_t* out, const Record& rec) noexcept {
+        if (rec.is_binary_record) {
+            return WRITE_BYTES(out, rec.raw_record);
+        }
+
+        for (size_t f = 0; f < rec.fields.size(); f++) {
+            const Field& field = rec.fields[f];
+            out = WRITE_BYTES(out, field.tag);
+            *out++ = ':';
+
+            if (field.is_binary_field) {
+                out = WRITE_BYTES(out, field.raw_field);
+                continue;
+            }
+
+            for (size_t s = 0; s < field.subfields.size(); s++) {
+                const auto& items = field.subfields[s].items;
+                for (size_t i = 0; i < items.size(); i++) {
+                    out = WRITE_BYTES(out, items[i].bytes);
+                    if (i + 1 != items.size()) {
+                        *out++ = US;
+                    }
+                }
+                if (s + 1 != field.subfields.size()) {
+                    *out++ = RS;
+                }
+            }
+            if (f + 1 != rec.fields.size()) {
+                *out++ = GS;
+            }
+        }
+        *out++ = FS;
+        return out;
+    }
+
     inline void UPDATE_CNT_FIELD(File& file) {
         if (file.records.empty()) {
             return;
@@ -100,42 +188,41 @@ namespace nnist {
             cnt_field->subfields.push_back(subfield);
         }
     }
-    inline void UPDATE_ALL_LENGTHS(File& file) {
-        for (auto& rec : file.records) {
-            if (rec.is_binary_record) {
-                auto size = (uint32_t)rec.raw_record.size();
-                rec.raw_record[BYTE_INDEX_0] = (size >> SHIFT_24) & BYTE_MASK;
-                rec.raw_record[BYTE_INDEX_1] = (size >> SHIFT_16) & BYTE_MASK;
-                rec.raw_record[BYTE_INDEX_2] = (size >> SHIFT_8) & BYTE_MASK;
-                rec.raw_record[BYTE_INDEX_3] = size & BYTE_MASK;
-            } else {
-                // Update tagged record .001
-                if (rec.fields.empty()) {
-                    continue;
-                }
-                Field* first_field = rec.fields.data();
+    inline void UPDATE_RECORD_LENGTH(Record& rec) {
+        if (rec.is_binary_record) {
+            const auto size = static_cast<uint32_t>(rec.raw_record.size());
+            rec.raw_record[BYTE_INDEX_0] =
+                static_cast<uint8_t>((size >> SHIFT_24) & BYTE_MASK);
+            rec.raw_record[BYTE_INDEX_1] =
+                static_cast<uint8_t>((size >> SHIFT_16) & BYTE_MASK);
+            rec.raw_record[BYTE_INDEX_2] =
+                static_cast<uint8_t>((size >> SHIFT_8) & BYTE_MASK);
+            rec.raw_record[BYTE_INDEX_3] =
+                static_cast<uint8_t>(size & BYTE_MASK);
+            return;
+        }
 
-                first_field->subfields = {{{{std::vector<uint8_t>(
-                    TAGGED_LEN_WIDTH, static_cast<uint8_t>('0'))}}}};
+        // Update tagged record .001
+        if (rec.fields.empty()) {
+            return;
+        }
+        Field* first_field = rec.fields.data();
 
-                auto calc = [&]() {
-                    std::vector<uint8_t> tmp;
-                    for (size_t i = 0; i < rec.fields.size(); i++) {
-                        SERIALIZE_FIELD(tmp, rec.fields[i],
-                                        i + 1 == rec.fields.size());
-                    }
-                    tmp.push_back(FS);
-                    return tmp.size();
-                };
-
-                std::string str = std::to_string(calc());
-                first_field->subfields[0].items[0].bytes = {str.begin(),
-                                                            str.end()};
-                // Double-pass for string length changes
-                str = std::to_string(calc());
-                first_field->subfields[0].items[0].bytes = {str.begin(),
-                                                            str.end()};
-            }
+        first_field->subfields = {{{{std::vector<uint8_t>(
+            TAGGED_LEN_WIDTH, static_cast<uint8_t>('0'))}}}};
+
+        auto calc = [&]() { return SERIALIZED_RECORD_SIZE(rec); };
+
+        std::string str = std::to_string(calc());
+        first_field->subfields[0].items[0].bytes = {str.begin(), str.end()};
+        // Double-pass for string length changes
+        str = std::to_string(calc());
+        first_field->subfields[0].items[0].bytes = {str.begin(), str.end()};
+    }
+
+    inline void UPDATE_ALL_LENGTHS(File& file) {
+        for (auto& rec : file.records) {
+            UPDATE_RECORD_LENGTH(rec);
         }
     }
     inline void PATCH_RECORD_LENGTHS(Record& rec) {
@@ -178,6 +265,135 @@ namespace nnist {
         return out;
     }
 
+    // ---- Copy-on-Write Serialization ----
+    // Marks a record for regeneration. Fields edited in place without this
+    // are not noticed: the record still counts as clean and its source
+    // bytes are emitted unchanged.
+    inline Record& EDIT_RECORD(File& file, size_t index) {
+        Record& rec = file.records.at(index);
+        rec.dirty = true;
+        return rec;
+    }
+
+    // Clean means unedited and parsed from `source` itself: a record copied
+    // in from another File keeps its own buffer's base and is regenerated.
+    // The span's bytes must still hash as they did at parse time, since a
+    // freed source buffer's address can be reused by unrelated bytes.
+    inline bool IS_CLEAN_RECORD(const Record& rec,
+                                std::span<const uint8_t> source) noexcept {
+        return !rec.dirty && rec.source_base == source.data() &&
+               rec.source_offset != INVALID_INDEX &&
+               rec.source_length > 0U &&
+               rec.source_length <= source.size() &&
+               rec.source_offset <= source.size() - rec.source_length &&
+               HASH_BYTES(source.subspan(rec.source_offset,
+                                         rec.source_length)) ==
+                   rec.source_hash;
+    }
+
+    // True when the Type-1 CNT (1.003) still describes file.records.
+    inline bool CNT_MATCHES_RECORDS(const File& file) noexcept {
+        if (file.records.empty()) {
+            return true;
+        }
+        const Record& type1 = file.records[0];
+        const size_t cnt_index = FIND_CNT_FIELD(type1);
+        if (cnt_index == INVALID_INDEX) {
+            return true;  // nothing for UPDATE_CNT_FIELD to rewrite
+        }
+
+        const auto& subfields = type1.fields[cnt_index].subfields;
+        if (subfields.empty() || subfields[0].items.empty() ||
+            subfields.size() != file.records.size()) {
+            return false;
+        }
+
+        // Standard form is "1<US><other record count>"; UPDATE_CNT_FIELD
+        // writes a single item holding the total record count.
+        const auto& count_items = subfields[0].items;
+        const bool standard_form = count_items.size() >= 2U;
+        size_t declared_count = 0U;
+        if (!PARSE_UNSIGNED(count_items[standard_form ? 1U : 0U].bytes,
+                            declared_count) ||
+            declared_count != (standard_form ? file.records.size() - 1U
+                                             : file.records.size())) {
+            return false;
+        }
+
+        for (size_t i = 1; i < subfields.size(); i++) {
+            int record_type = -1;
+            int idc = -1;
+            bool valid = true;
+            if (!READ_CNT_ENTRY(subfields[i], record_type, idc, valid) ||
+                record_type != file.records[i].type ||
+                idc != std::max(file.records[i].idc, 0)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Output as a list of byte ranges: clean records point straight into
+    // the source buffer, regenerated ones into `owned`. Both the source and
+    // this object must outlive the segments.
+    struct SerializedSegments {
+        std::vector<std::span<const uint8_t>> segments;
+        std::deque<std::vector<uint8_t>> owned;
+
+        [[nodiscard]] size_t size() const noexcept {
+            size_t total = 0U;
+            for (const auto& segment : segments) {
+                total += segment.size();
+            }
+            return total;
+        }
+
+        [[nodiscard]] std::vector<uint8_t> flatten() const {
+            std::vector<uint8_t> out;
+            out.reserve(size());
+            for (const auto& segment : segments) {
+                out.insert(out.end(), segment.begin(), segment.end());
+            }
+            return out;
+        }
+    };
+
+    // Serializes `file` against the buffer it was parsed from. Records that
+    // were not edited (see EDIT_RECORD) are referenced byte-for-byte from
+    // `source`; dirty records, and records parsed from any other buffer,
+    // are regenerated and have their LEN patched. Direct field edits
+    // without EDIT_RECORD are dropped. The Type-1 record is regenerated only
+    // when the record list no longer matches its CNT.
+    inline SerializedSegments SERIALIZE_FILE_SEGMENTS(
+        File& file, std::span<const uint8_t> source) {
+        if (!CNT_MATCHES_RECORDS(file)) {
+            UPDATE_CNT_FIELD(file);
+            file.records[0].dirty = true;
+        }
+
+        SerializedSegments out;
+        out.segments.reserve(file.records.size());
+
+        for (auto& rec : file.records) {
+            if (IS_CLEAN_RECORD(rec, source)) {
+                out.segments.push_back(
+                    source.subspan(rec.source_offset, rec.source_length));
+                continue;
+            }
+
+            UPDATE_RECORD_LENGTH(rec);
+            auto& bytes = out.owned.emplace_back();
+            SERIALIZE_RECORD(bytes, rec);
+            out.segments.emplace_back(bytes);
+        }
+        return out;
+    }
+
+    inline std::vector<uint8_t> SERIALIZE_FILE(
+        File& file, std::span<const uint8_t> source) {
+        return SERIALIZE_FILE_SEGMENTS(file, source).flatten();
+    }
+
     // ---- File IO ----
     inline std::vector<uint8_t> READ_FILE(const std::filesystem::path& path) {
         std::ifstream file(path, std::ios::binary);
@@ -195,4 +411,14 @@ namespace nnist {
 
         file.write(reinterpret_cast<const char*>(data.data()), byte_count);
     }
+
+    inline void WRITE_FILE(const std::filesystem::path& path,
+                           const SerializedSegments& data) {
+        std::ofstream file(path, std::ios::binary);
+        for (const auto& segment : data.segments) {
+            file.write(reinterpret_cast<const char*>(segment.data()),
+                       static_cast<std::streamsize>(segment.size()));
+        }
+    }
 }  // namespace nnist
+#endif
@@ -0,0 +1,103 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include "nnist/parallel.h"
+#include "nnist/serdes.h"
+#include "nnist/types.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace nnist {
+
+    // --------------------------------------------
+    // Parallel Serialization
+    // --------------------------------------------
+    // Patches every record's LEN and measures it independently, assigns
+    // output offsets by prefix sum, then lets `write(offsets, total)` fill
+    // the disjoint slices concurrently. Output is byte-identical to
+    // SERIALIZE_FILE.
+    inline std::vector<size_t> LAYOUT_RECORDS_PARALLEL(File& file,
+                                                       size_t thread_count) {
+        const size_t count = file.records.size();
+        std::vector<size_t> offsets(count + 1U, 0U);
+
+        PARALLEL_FOR(count, thread_count, [&](size_t i) {
+            UPDATE_RECORD_LENGTH(file.records[i]);
+            offsets[i + 1U] = SERIALIZED_RECORD_SIZE(file.records[i]);
+        });
+
+        for (size_t i = 0; i < count; i++) {
+            offsets[i + 1U] += offsets[i];
+        }
+        return offsets;
+    }
+
+    inline std::vector<uint8_t> SERIALIZE_FILE_PARALLEL(
+        File& file, size_t thread_count = 0U) {
+        const auto offsets = LAYOUT_RECORDS_PARALLEL(file, thread_count);
+        std::vector<uint8_t> out(offsets.back());
+
+        PARALLEL_FOR(file.records.size(), thread_count, [&](size_t i) {
+            WRITE_RECORD(out.data() + offsets[i], file.records[i]);
+        });
+        return out;
+    }
+
+    // Same as above, but records are written straight into a mapped output
+    // file, so the serialized transaction never exists as one heap buffer.
+    inline void SERIALIZE_FILE_PARALLEL(File& file,
+                                        const std::filesystem::path& path,
+                                        size_t thread_count = 0U) {
+#if defined(_WIN32)
+        WRITE_FILE(path, SERIALIZE_FILE_PARALLEL(file, thread_count));
+#else
+        const auto offsets = LAYOUT_RECORDS_PARALLEL(file, thread_count);
+        const size_t total = offsets.back();
+
+        const int descriptor =
+            ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+                   S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+        if (descriptor < 0) {
+            throw std::runtime_error("Failed to open file: " + path.string());
+        }
+        if (total == 0U) {
+            ::close(descriptor);
+            return;
+        }
+        if (::ftruncate(descriptor, static_cast<off_t>(total)) != 0) {
+            ::close(descriptor);
+            throw std::runtime_error("Failed to size file: " + path.string());
+        }
+
+        void* mapping = ::mmap(nullptr, total, PROT_READ | PROT_WRITE,
+                               MAP_SHARED, descriptor, 0);
+        ::close(descriptor);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Failed to map file: " + path.string());
+        }
+
+        auto* out = static_cast<uint8_t*>(mapping);
+        try {
+            PARALLEL_FOR(file.records.size(), thread_count, [&](size_t i) {
+                WRITE_RECORD(out + offsets[i], file.records[i]);
+            });
+        } catch (...) {
+            ::munmap(mapping, total);
+            throw;
+        }
+        ::munmap(mapping, total);
+#endif
+    }
+
+}  // namespace nnist
+#endif
@@ -0,0 +1,158 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "nnist/mapped_file.h"
+#include "nnist/parsers.h"
+#include "nnist/serdes.h"
+#include "nnist/storage.h"
+#include "nnist/types.h"
+
+namespace nnist {
+
+    using ViewItem = BasicItem<ViewStorage>;
+    using ViewSubfield = BasicSubfield<ViewStorage>;
+    using ViewField = BasicField<ViewStorage>;
+    using ViewRecord = BasicRecord<ViewStorage>;
+    using ViewFile = BasicFile<ViewStorage>;
+
+    // --------------------------------------------
+    // Shared Immutable Transaction
+    // --------------------------------------------
+    // A parsed transaction and the buffer it was parsed from, held behind
+    // one reference count. Every byte string in the File is a view into
+    // that buffer, so the bytes exist once however many stages hold the
+    // transaction. Copying a handle is an atomic increment. Nothing is
+    // mutable after construction, so any number of threads may read one
+    // transaction without locking. Stages that edit records take a heap
+    // copy with to_file().
+    class SharedTransaction {
+      public:
+        SharedTransaction() = default;
+
+        // Takes ownership of `buffer` and parses it. Throws as PARSE_FILE.
+        explicit SharedTransaction(std::vector<uint8_t> buffer) {
+            auto owner =
+                std::make_shared<const std::vector<uint8_t>>(std::move(buffer));
+            const std::span<const uint8_t> bytes(*owner);
+            adopt(std::move(owner), bytes);
+        }
+
+        // Takes ownership of a mapping; pages stay mapped while any handle
+        // or record handle is alive.
+        explicit SharedTransaction(MappedFile mapped) {
+            auto owner = std::make_shared<const MappedFile>(std::move(mapped));
+            const std::span<const uint8_t> bytes = owner->bytes();
+            adopt(std::move(owner), bytes);
+        }
+
+        [[nodiscard]] explicit operator bool() const noexcept {
+            return state_ != nullptr;
+        }
+
+        // The whole transaction as received.
+        [[nodiscard]] std::span<const uint8_t> bytes() const noexcept {
+            return state_ ? state_->bytes : std::span<const uint8_t>{};
+        }
+
+        // The parsed File; an empty one for a default-constructed handle.
+        [[nodiscard]] const ViewFile& file() const noexcept {
+            static const ViewFile EMPTY_FILE;
+            return state_ ? state_->file : EMPTY_FILE;
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return state_ ? state_->file.records.size() : 0U;
+        }
+
+        // Unchecked, like std::vector: `index` must be below size().
+        [[nodiscard]] const ViewRecord& operator[](size_t index) const {
+            return state_->file.records[index];
+        }
+
+        // Checked access; throws std::out_of_range past size(), which
+        // includes every index on an empty handle.
+        [[nodiscard]] const ViewRecord& at(size_t index) const {
+            if (index >= size()) {
+                throw std::out_of_range("Record index out of range");
+            }
+            return state_->file.records[index];
+        }
+
+        // A handle to one record that keeps the whole transaction alive, for
+        // consumers that only care about a single record.
+        [[nodiscard]] std::shared_ptr<const ViewRecord> record(
+            size_t index) const {
+            return {state_, &at(index)};
+        }
+
+        // Exact LEN span of a record within bytes(). Checked as at().
+        [[nodiscard]] std::span<const uint8_t> record_bytes(
+            size_t index) const {
+            const ViewRecord& record = at(index);
+            if (record.source_offset == INVALID_INDEX) {
+                return {};
+            }
+            return bytes().subspan(record.source_offset,
+                                   record.source_length);
+        }
+
+        // Owning, mutable copy; re-parses bytes() into a heap File.
+        [[nodiscard]] File to_file() const {
+            File file;
+            const PARSE_STATUS status = PARSE_FILE_INTO(bytes(), file);
+            if (status != PARSE_OK) {
+                throw std::runtime_error(PARSE_STATUS_MESSAGE(status));
+            }
+            return file;
+        }
+
+        // Handles (including record handles) sharing this transaction.
+        [[nodiscard]] long use_count() const noexcept {
+            return state_.use_count();
+        }
+
+      private:
+        struct State {
+            std::shared_ptr<const void> owner;
+            std::span<const uint8_t> bytes;
+            ViewFile file;
+        };
+
+        void adopt(std::shared_ptr<const void> owner,
+                   std::span<const uint8_t> bytes) {
+            auto state = std::make_shared<State>();
+            state->owner = std::move(owner);
+            state->bytes = bytes;
+            const PARSE_STATUS status = PARSE_FILE_INTO(bytes, state->file);
+            if (status != PARSE_OK) {
+                throw std::runtime_error(PARSE_STATUS_MESSAGE(status));
+            }
+            state_ = std::move(state);
+        }
+
+        std::shared_ptr<const State> state_;
+    };
+
+    // READ_FILE + SharedTransaction.
+    inline SharedTransaction READ_SHARED_TRANSACTION(
+        const std::filesystem::path& path) {
+        return SharedTransaction(READ_FILE(path));
+    }
+
+    // Maps `path` instead of reading it; the File views the mapping.
+    inline SharedTransaction MAP_SHARED_TRANSACTION(
+        const std::filesystem::path& path) {
+        return SharedTransaction(MappedFile(path));
+    }
+
+}  // namespace nnist
+#endif
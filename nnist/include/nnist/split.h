@@ -0,0 +1,143 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include "nnist/parallel.h"
+#include "nnist/parsers.h"
+#include "nnist/scan.h"
+#include "nnist/types.h"
+
+namespace nnist {
+
+    // --------------------------------------------
+    // Multi-Transaction Splitting
+    // --------------------------------------------
+    enum SPLIT_MODE : uint8_t {
+        SPLIT_STRICT = 0,  // stop at the first malformed transaction
+        SPLIT_RESYNC       // skip ahead to the next plausible Type-1 header
+    };
+
+    struct TransactionSpan {
+        size_t offset = 0U;
+        size_t length = 0U;
+        size_t record_count = 0U;  // including Type-1
+    };
+
+    struct SplitError {
+        size_t offset = 0U;  // start of the transaction that failed
+        PARSE_STATUS status = PARSE_OK;
+        size_t resumed_at = INVALID_INDEX;  // next header found (RESYNC)
+    };
+
+    struct SplitResult {
+        std::vector<TransactionSpan> transactions;
+        std::vector<SplitError> errors;
+    };
+
+    // A plausible Type-1 header has a well-formed "1.001:<LEN>" (or "1.01:")
+    // prefix whose LEN stays in bounds and lands on an FS.
+    inline bool IS_PLAUSIBLE_TYPE1(std::span<const uint8_t> buffer,
+                                   size_t offset) noexcept {
+        int record_type = -1;
+        size_t length = 0U;
+        return READ_TAGGED_HEADER(buffer, offset, record_type, length) &&
+               record_type == RECORD_TYPE_1 &&
+               length <= buffer.size() - offset &&
+               buffer[offset + length - 1U] == FS;
+    }
+
+    inline size_t FIND_NEXT_TYPE1_HEADER(std::span<const uint8_t> buffer,
+                                         size_t from) noexcept {
+        while (from < buffer.size()) {
+            const void* hit = std::memchr(buffer.data() + from, '1',
+                                          buffer.size() - from);
+            if (hit == nullptr) {
+                break;
+            }
+            from = static_cast<size_t>(static_cast<const uint8_t*>(hit) -
+                                       buffer.data());
+            if (IS_PLAUSIBLE_TYPE1(buffer, from)) {
+                return from;
+            }
+            ++from;
+        }
+        return INVALID_INDEX;
+    }
+
+    // Finds transaction boundaries in a blob of concatenated transactions by
+    // LEN hops alone (see SCAN_RECORDS); no record content is tokenized.
+    inline SplitResult SPLIT_TRANSACTIONS(std::span<const uint8_t> buffer,
+                                          SPLIT_MODE mode = SPLIT_STRICT) {
+        SplitResult result;
+        size_t offset = SKIP_SEPARATORS(buffer, 0U);
+
+        while (offset < buffer.size()) {
+            TransactionSpan transaction;
+            transaction.offset = offset;
+
+            size_t end_offset = offset;
+            const PARSE_STATUS status = SCAN_RECORDS(
+                buffer, offset,
+                [&](const RecordSpan&) {
+                    ++transaction.record_count;
+                    return true;
+                },
+                end_offset);
+
+            if (status == PARSE_OK && end_offset > offset) {
+                transaction.length = end_offset - offset;
+                result.transactions.push_back(transaction);
+                offset = end_offset;
+                continue;
+            }
+
+            SplitError error;
+            error.offset = offset;
+            error.status = status;
+            if (mode == SPLIT_RESYNC) {
+                error.resumed_at = FIND_NEXT_TYPE1_HEADER(buffer, offset + 1U);
+            }
+            result.errors.push_back(error);
+
+            if (error.resumed_at == INVALID_INDEX) {
+                break;
+            }
+            offset = error.resumed_at;
+        }
+
+        return result;
+    }
+
+    // --------------------------------------------
+    // Parallel Parse Stage
+    // --------------------------------------------
+    struct ParsedTransaction {
+        TransactionSpan span;
+        PARSE_STATUS status = PARSE_OK;
+        File file;
+    };
+
+    // Parses each transaction independently on up to `thread_count` threads
+    // (0 = hardware concurrency). Results keep the order of `spans`.
+    inline std::vector<ParsedTransaction> PARSE_TRANSACTIONS(
+        std::span<const uint8_t> buffer,
+        const std::vector<TransactionSpan>& spans, size_t thread_count = 0U) {
+        std::vector<ParsedTransaction> parsed(spans.size());
+
+        PARALLEL_FOR(spans.size(), thread_count, [&](size_t i) {
+            parsed[i].span = spans[i];
+            parsed[i].status = PARSE_FILE_INTO(
+                buffer.subspan(spans[i].offset, spans[i].length),
+                parsed[i].file);
+        });
+
+        return parsed;
+    }
+
+}  // namespace nnist
+#endif
@@ -0,0 +1,371 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <vector>
+#endif
+
+namespace nnist {
+
+    // --------------------------------------------
+    // Inline Vector (Fixed Capacity, No Heap)
+    // --------------------------------------------
+    template <typename T, size_t CAPACITY>
+    class InlineVector {
+      public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        [[nodiscard]] static constexpr size_t capacity() noexcept {
+            return CAPACITY;
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0U; }
+        [[nodiscard]] bool full() const noexcept { return size_ == CAPACITY; }
+
+        [[nodiscard]] T* data() noexcept { return storage_.data(); }
+        [[nodiscard]] const T* data() const noexcept { return storage_.data(); }
+
+        [[nodiscard]] iterator begin() noexcept { return storage_.data(); }
+        [[nodiscard]] iterator end() noexcept {
+            return storage_.data() + size_;
+        }
+        [[nodiscard]] const_iterator begin() const noexcept {
+            return storage_.data();
+        }
+        [[nodiscard]] const_iterator end() const noexcept {
+            return storage_.data() + size_;
+        }
+
+        [[nodiscard]] T& operator[](size_t index) noexcept {
+            return storage_[index];
+        }
+        [[nodiscard]] const T& operator[](size_t index) const noexcept {
+            return storage_[index];
+        }
+
+        [[nodiscard]] T& front() noexcept { return storage_[0]; }
+        [[nodiscard]] const T& front() const noexcept { return storage_[0]; }
+        [[nodiscard]] T& back() noexcept { return storage_[size_ - 1U]; }
+        [[nodiscard]] const T& back() const noexcept {
+            return storage_[size_ - 1U];
+        }
+
+        // Returns false (and leaves the vector untouched) when full.
+        bool try_push_back(const T& value) noexcept {
+            if (full()) {
+                return false;
+            }
+            storage_[size_++] = value;
+            return true;
+        }
+
+        bool try_push_back(T&& value) noexcept {
+            if (full()) {
+                return false;
+            }
+            storage_[size_++] = static_cast<T&&>(value);
+            return true;
+        }
+
+        // Appends a default-constructed element; nullptr when full. Only
+        // the new slot is reset, so T should stay small (see FixedStorage).
+        T* try_emplace_back() noexcept {
+            if (full()) {
+                return nullptr;
+            }
+            storage_[size_] = T{};
+            return &storage_[size_++];
+        }
+
+        // Stale elements are left in place and reset when reused.
+        void clear() noexcept { size_ = 0U; }
+
+      private:
+        std::array<T, CAPACITY> storage_{};
+        size_t size_ = 0U;
+    };
+
+    // --------------------------------------------
+    // Pool Lists (Flat Per-File Arenas)
+    // --------------------------------------------
+    // A list that owns no elements: it is a [offset, offset + size) range
+    // of one flat pool held by `Pools` (see FixedPools in types.h). Lists
+    // are filled one at a time in parse order, so each list only ever
+    // appends at the end of its pool; appending to a list that is no longer
+    // the pool's tail fails like a full pool. Lists default to unattached
+    // and cannot grow until their owner attaches them to the pools.
+    template <typename T, typename Pools>
+    class PoolList {
+      public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0U; }
+
+        [[nodiscard]] T* data() noexcept {
+            return pools_ == nullptr ? nullptr : pool().data() + offset_;
+        }
+        [[nodiscard]] const T* data() const noexcept {
+            return pools_ == nullptr ? nullptr : pool().data() + offset_;
+        }
+
+        [[nodiscard]] iterator begin() noexcept { return data(); }
+        [[nodiscard]] iterator end() noexcept { return data() + size_; }
+        [[nodiscard]] const_iterator begin() const noexcept { return data(); }
+        [[nodiscard]] const_iterator end() const noexcept {
+            return data() + size_;
+        }
+
+        [[nodiscard]] T& operator[](size_t index) noexcept {
+            return data()[index];
+        }
+        [[nodiscard]] const T& operator[](size_t index) const noexcept {
+            return data()[index];
+        }
+
+        [[nodiscard]] T& front() noexcept { return data()[0]; }
+        [[nodiscard]] const T& front() const noexcept { return data()[0]; }
+        [[nodiscard]] T& back() noexcept { return data()[size_ - 1U]; }
+        [[nodiscard]] const T& back() const noexcept {
+            return data()[size_ - 1U];
+        }
+
+        bool try_push_back(const T& value) noexcept {
+            T* slot = try_emplace_back();
+            if (slot == nullptr) {
+                return false;
+            }
+            *slot = value;
+            return true;
+        }
+
+        // Appends at the pool's tail; nullptr when the pool is full, this
+        // list is not the tail, or the list is unattached.
+        T* try_emplace_back() noexcept {
+            if (pools_ == nullptr) {
+                return nullptr;
+            }
+            auto& elements = pool();
+            if (size_ == 0U) {
+                offset_ = elements.size();
+            } else if (offset_ + size_ != elements.size()) {
+                return nullptr;
+            }
+            T* slot = elements.try_emplace_back();
+            if (slot == nullptr) {
+                return nullptr;
+            }
+            pools_->attach(*slot);
+            ++size_;
+            return slot;
+        }
+
+        // Pool space is reclaimed when the owning File is cleared.
+        void clear() noexcept { size_ = 0U; }
+
+        void attach(Pools* pools) noexcept {
+            pools_ = pools;
+            offset_ = 0U;
+            size_ = 0U;
+        }
+
+      private:
+        [[nodiscard]] auto& pool() noexcept {
+            return pools_->pool(static_cast<T*>(nullptr));
+        }
+        [[nodiscard]] const auto& pool() const noexcept {
+            return static_cast<const Pools*>(pools_)->pool(
+                static_cast<const T*>(nullptr));
+        }
+
+        Pools* pools_ = nullptr;
+        size_t offset_ = 0U;
+        size_t size_ = 0U;
+    };
+
+    // The record list of a pooled File: records inline, plus the pools their
+    // fields, subfields and items live in. Lists point into the pools, so
+    // the File is pinned in place (neither copyable nor movable). clear()
+    // resets every pool in O(1).
+    template <typename T, size_t CAPACITY, typename Pools>
+    class PoolRoot {
+      public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        PoolRoot() = default;
+        PoolRoot(const PoolRoot&) = delete;
+        PoolRoot& operator=(const PoolRoot&) = delete;
+
+        [[nodiscard]] static constexpr size_t capacity() noexcept {
+            return CAPACITY;
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return records_.size(); }
+        [[nodiscard]] bool empty() const noexcept { return records_.empty(); }
+        [[nodiscard]] bool full() const noexcept { return records_.full(); }
+
+        [[nodiscard]] T* data() noexcept { return records_.data(); }
+        [[nodiscard]] const T* data() const noexcept {
+            return records_.data();
+        }
+
+        [[nodiscard]] iterator begin() noexcept { return records_.begin(); }
+        [[nodiscard]] iterator end() noexcept { return records_.end(); }
+        [[nodiscard]] const_iterator begin() const noexcept {
+            return records_.begin();
+        }
+        [[nodiscard]] const_iterator end() const noexcept {
+            return records_.end();
+        }
+
+        [[nodiscard]] T& operator[](size_t index) noexcept {
+            return records_[index];
+        }
+        [[nodiscard]] const T& operator[](size_t index) const noexcept {
+            return records_[index];
+        }
+
+        [[nodiscard]] T& front() noexcept { return records_.front(); }
+        [[nodiscard]] const T& front() const noexcept {
+            return records_.front();
+        }
+        [[nodiscard]] T& back() noexcept { return records_.back(); }
+        [[nodiscard]] const T& back() const noexcept {
+            return records_.back();
+        }
+
+        T* try_emplace_back() noexcept {
+            T* record = records_.try_emplace_back();
+            if (record != nullptr) {
+                pools_.attach(*record);
+            }
+            return record;
+        }
+
+        void clear() noexcept {
+            records_.clear();
+            pools_.clear();
+        }
+
+        [[nodiscard]] const Pools& pools() const noexcept { return pools_; }
+
+      private:
+        InlineVector<T, CAPACITY> records_;
+        Pools pools_;
+    };
+
+    // --------------------------------------------
+    // Storage Policies
+    // --------------------------------------------
+
+#if !NNIST_FREESTANDING
+    // Owning, growable storage. Byte strings are copied out of the input
+    // buffer, so a parsed File outlives the buffer it came from.
+    struct HeapStorage {
+        static constexpr bool IS_FIXED = false;
+
+        using Bytes = std::vector<uint8_t>;
+
+        template <typename T>
+        using ItemList = std::vector<T>;
+        template <typename T>
+        using SubfieldList = std::vector<T>;
+        template <typename T>
+        using FieldList = std::vector<T>;
+        template <typename T>
+        using RecordList = std::vector<T>;
+    };
+
+    // Growable lists whose byte strings are views into the input buffer:
+    // only the record/field/subfield/item tables are allocated, never the
+    // bytes. The buffer must outlive the parsed File (see SharedTransaction).
+    struct ViewStorage {
+        static constexpr bool IS_FIXED = false;
+
+        using Bytes = std::span<const uint8_t>;
+
+        template <typename T>
+        using ItemList = std::vector<T>;
+        template <typename T>
+        using SubfieldList = std::vector<T>;
+        template <typename T>
+        using FieldList = std::vector<T>;
+        template <typename T>
+        using RecordList = std::vector<T>;
+    };
+
+#endif
+
+    template <typename Storage>
+    struct FixedPools;  // defined in types.h, once the element types exist
+
+    // Fixed-capacity storage sized at compile time. Nothing is allocated:
+    // records are inline in the File and every field, subfield and item of
+    // the File comes from one flat pool per kind, so capacities are totals
+    // per File (not per record) and memory is their sum, not their product.
+    // Byte strings are views into the input buffer, which must outlive the
+    // parsed File. Exceeding any capacity makes parsing fail with
+    // PARSE_CAPACITY_EXCEEDED. Records parse only inside a File.
+    template <size_t MAX_RECORDS, size_t MAX_FIELDS, size_t MAX_SUBFIELDS,
+              size_t MAX_ITEMS>
+    struct FixedStorage {
+        static constexpr bool IS_FIXED = true;
+        static constexpr size_t FIELD_CAPACITY = MAX_FIELDS;
+        static constexpr size_t SUBFIELD_CAPACITY = MAX_SUBFIELDS;
+        static constexpr size_t ITEM_CAPACITY = MAX_ITEMS;
+
+        using Bytes = std::span<const uint8_t>;
+        using Pools = FixedPools<FixedStorage>;
+
+        template <typename T>
+        using ItemList = PoolList<T, Pools>;
+        template <typename T>
+        using SubfieldList = PoolList<T, Pools>;
+        template <typename T>
+        using FieldList = PoolList<T, Pools>;
+        template <typename T>
+        using RecordList = PoolRoot<T, MAX_RECORDS, Pools>;
+    };
+
+    // --------------------------------------------
+    // Policy-Neutral Helpers
+    // --------------------------------------------
+    template <typename List, typename T>
+    inline bool APPEND(List& list, T&& value) {
+        if constexpr (requires {
+                          list.try_push_back(static_cast<T&&>(value));
+                      }) {
+            return list.try_push_back(static_cast<T&&>(value));
+        } else {
+            list.push_back(static_cast<T&&>(value));
+            return true;
+        }
+    }
+
+    template <typename List>
+    inline auto* EMPLACE(List& list) {
+        if constexpr (requires { list.try_emplace_back(); }) {
+            return list.try_emplace_back();
+        } else {
+            return &list.emplace_back();
+        }
+    }
+
+    template <typename Bytes>
+    inline Bytes MAKE_BYTES(std::span<const uint8_t> bytes) {
+        return Bytes(bytes.begin(), bytes.end());
+    }
+
+}  // namespace nnist
@@ -0,0 +1,582 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "nnist/parsers.h"
+#include "nnist/scan.h"
+#include "nnist/types.h"
+
+#if NNIST_HAS_ZLIB
+#include <zlib.h>
+#endif
+#if NNIST_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+namespace nnist {
+
+    constexpr size_t DEFAULT_STREAM_CHUNK = 256U * 1024U;
+    constexpr size_t DEFAULT_PREFETCH_CHUNKS = 4U;
+
+    // --------------------------------------------
+    // Byte Sources
+    // --------------------------------------------
+    class ByteSource {
+      public:
+        virtual ~ByteSource() = default;
+
+        // Reads up to `buffer.size()` bytes; returns 0 only at end of input.
+        virtual size_t read(std::span<uint8_t> buffer) = 0;
+    };
+
+    class MemoryByteSource final : public ByteSource {
+      public:
+        explicit MemoryByteSource(std::span<const uint8_t> bytes) noexcept
+            : bytes_(bytes) {}
+
+        size_t read(std::span<uint8_t> buffer) override {
+            const size_t count = std::min(buffer.size(), bytes_.size());
+            std::copy_n(bytes_.begin(), count, buffer.begin());
+            bytes_ = bytes_.subspan(count);
+            return count;
+        }
+
+      private:
+        std::span<const uint8_t> bytes_;
+    };
+
+    class FileByteSource final : public ByteSource {
+      public:
+        explicit FileByteSource(const std::filesystem::path& path)
+            : file_(path, std::ios::binary) {
+            if (!file_) {
+                throw std::runtime_error("Failed to open file: " +
+                                         path.string());
+            }
+        }
+
+        size_t read(std::span<uint8_t> buffer) override {
+            file_.read(reinterpret_cast<char*>(buffer.data()),
+                       static_cast<std::streamsize>(buffer.size()));
+            return static_cast<size_t>(file_.gcount());
+        }
+
+      private:
+        std::ifstream file_;
+    };
+
+    // Replays bytes already consumed (e.g. for magic detection) before
+    // continuing with the upstream source.
+    class PrefixedByteSource final : public ByteSource {
+      public:
+        PrefixedByteSource(std::vector<uint8_t> prefix,
+                           std::unique_ptr<ByteSource> upstream)
+            : prefix_(std::move(prefix)), upstream_(std::move(upstream)) {}
+
+        size_t read(std::span<uint8_t> buffer) override {
+            if (offset_ < prefix_.size()) {
+                const size_t count =
+                    std::min(buffer.size(), prefix_.size() - offset_);
+                std::copy_n(prefix_.begin() + static_cast<ptrdiff_t>(offset_),
+                            count, buffer.begin());
+                offset_ += count;
+                return count;
+            }
+            return upstream_->read(buffer);
+        }
+
+      private:
+        std::vector<uint8_t> prefix_;
+        size_t offset_ = 0U;
+        std::unique_ptr<ByteSource> upstream_;
+    };
+
+    // --------------------------------------------
+    // Decompressing Sources
+    // --------------------------------------------
+#if NNIST_HAS_ZLIB
+    // gzip (and zlib) streams, including concatenated gzip members.
+    class GzipByteSource final : public ByteSource {
+      public:
+        explicit GzipByteSource(std::unique_ptr<ByteSource> upstream,
+                                size_t chunk_size = DEFAULT_STREAM_CHUNK)
+            : upstream_(std::move(upstream)), input_(chunk_size) {
+            constexpr int AUTO_DETECT_GZIP_ZLIB = 15 + 32;
+            if (inflateInit2(&stream_, AUTO_DETECT_GZIP_ZLIB) != Z_OK) {
+                throw std::runtime_error("inflateInit2 failed");
+            }
+        }
+
+        ~GzipByteSource() override { inflateEnd(&stream_); }
+
+        GzipByteSource(const GzipByteSource&) = delete;
+        GzipByteSource& operator=(const GzipByteSource&) = delete;
+
+        size_t read(std::span<uint8_t> buffer) override {
+            stream_.next_out = buffer.data();
+            stream_.avail_out = static_cast<uInt>(buffer.size());
+
+            while (stream_.avail_out == buffer.size()) {
+                if (stream_.avail_in == 0U) {
+                    const size_t count = upstream_->read(input_);
+                    if (count == 0U) {
+                        if (!finished_) {
+                            throw std::runtime_error("Truncated gzip stream");
+                        }
+                        break;
+                    }
+                    stream_.next_in = input_.data();
+                    stream_.avail_in = static_cast<uInt>(count);
+                }
+
+                if (finished_) {
+                    // Another gzip member follows the previous one.
+                    inflateReset(&stream_);
+                    finished_ = false;
+                }
+
+                const int result = inflate(&stream_, Z_NO_FLUSH);
+                if (result == Z_STREAM_END) {
+                    finished_ = true;
+                } else if (result != Z_OK && result != Z_BUF_ERROR) {
+                    throw std::runtime_error("Corrupt gzip stream");
+                }
+            }
+
+            return buffer.size() - stream_.avail_out;
+        }
+
+      private:
+        std::unique_ptr<ByteSource> upstream_;
+        std::vector<uint8_t> input_;
+        z_stream stream_{};
+        bool finished_ = false;
+    };
+#endif
+
+#if NNIST_HAS_ZSTD
+    class ZstdByteSource final : public ByteSource {
+      public:
+        explicit ZstdByteSource(std::unique_ptr<ByteSource> upstream)
+            : upstream_(std::move(upstream)),
+              input_(ZSTD_DStreamInSize()),
+              stream_(ZSTD_createDStream()) {
+            if (stream_ == nullptr ||
+                ZSTD_isError(ZSTD_initDStream(stream_)) != 0U) {
+                ZSTD_freeDStream(stream_);
+                throw std::runtime_error("ZSTD_initDStream failed");
+            }
+        }
+
+        ~ZstdByteSource() override { ZSTD_freeDStream(stream_); }
+
+        ZstdByteSource(const ZstdByteSource&) = delete;
+        ZstdByteSource& operator=(const ZstdByteSource&) = delete;
+
+        size_t read(std::span<uint8_t> buffer) override {
+            ZSTD_outBuffer out{buffer.data(), buffer.size(), 0U};
+
+            while (out.pos == 0U) {
+                if (in_.pos == in_.size) {
+                    const size_t count = upstream_->read(input_);
+                    if (count == 0U) {
+                        if (!frame_done_) {
+                            throw std::runtime_error("Truncated zstd stream");
+                        }
+                        break;
+                    }
+                    in_ = {input_.data(), count, 0U};
+                }
+
+                const size_t result =
+                    ZSTD_decompressStream(stream_, &out, &in_);
+                if (ZSTD_isError(result) != 0U) {
+                    throw std::runtime_error(ZSTD_getErrorName(result));
+                }
+                frame_done_ = result == 0U;
+            }
+
+            return out.pos;
+        }
+
+      private:
+        std::unique_ptr<ByteSource> upstream_;
+        std::vector<uint8_t> input_;
+        ZSTD_DStream* stream_ = nullptr;
+        ZSTD_inBuffer in_{nullptr, 0U, 0U};
+        bool frame_done_ = true;
+    };
+#endif
+
+    // --------------------------------------------
+    // Background Prefetch (Decompress Ahead)
+    // --------------------------------------------
+    // Pulls the upstream source on its own thread into at most
+    // `max_chunks` buffered chunks, so decompression overlaps parsing while
+    // memory stays bounded.
+    class ThreadedByteSource final : public ByteSource {
+      public:
+        explicit ThreadedByteSource(
+            std::unique_ptr<ByteSource> upstream,
+            size_t chunk_size = DEFAULT_STREAM_CHUNK,
+            size_t max_chunks = DEFAULT_PREFETCH_CHUNKS)
+            : upstream_(std::move(upstream)),
+              chunk_size_(chunk_size),
+              max_chunks_(max_chunks == 0U ? 1U : max_chunks),
+              worker_([this]() { produce(); }) {}
+
+        ~ThreadedByteSource() override {
+            {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            changed_.notify_all();
+            worker_.join();
+        }
+
+        ThreadedByteSource(const ThreadedByteSource&) = delete;
+        ThreadedByteSource& operator=(const ThreadedByteSource&) = delete;
+
+        size_t read(std::span<uint8_t> buffer) override {
+            std::unique_lock<std::mutex> lock(mutex_);
+            changed_.wait(lock, [this]() {
+                return !chunks_.empty() || finished_;
+            });
+
+            if (chunks_.empty()) {
+                if (failure_) {
+                    std::rethrow_exception(failure_);
+                }
+                return 0U;
+            }
+
+            auto& chunk = chunks_.front();
+            const size_t count =
+                std::min(buffer.size(), chunk.size() - chunk_offset_);
+            std::copy_n(
+                chunk.begin() + static_cast<ptrdiff_t>(chunk_offset_), count,
+                buffer.begin());
+            chunk_offset_ += count;
+
+            if (chunk_offset_ == chunk.size()) {
+                chunks_.pop_front();
+                chunk_offset_ = 0U;
+                lock.unlock();
+                changed_.notify_all();
+            }
+            return count;
+        }
+
+      private:
+        void produce() {
+            try {
+                while (true) {
+                    std::vector<uint8_t> chunk(chunk_size_);
+                    const size_t count = upstream_->read(chunk);
+                    chunk.resize(count);
+
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    if (count == 0U || stopping_) {
+                        break;
+                    }
+                    changed_.wait(lock, [this]() {
+                        return chunks_.size() < max_chunks_ || stopping_;
+                    });
+                    if (stopping_) {
+                        break;
+                    }
+                    chunks_.push_back(std::move(chunk));
+                    lock.unlock();
+                    changed_.notify_all();
+                }
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                failure_ = std::current_exception();
+            }
+
+            {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                finished_ = true;
+            }
+            changed_.notify_all();
+        }
+
+        std::unique_ptr<ByteSource> upstream_;
+        size_t chunk_size_;
+        size_t max_chunks_;
+
+        std::mutex mutex_;
+        std::condition_variable changed_;
+        std::deque<std::vector<uint8_t>> chunks_;
+        size_t chunk_offset_ = 0U;
+        bool stopping_ = false;
+        bool finished_ = false;
+        std::exception_ptr failure_;
+
+        std::thread worker_;  // last: starts after the state above exists
+    };
+
+    // --------------------------------------------
+    // Format Detection
+    // --------------------------------------------
+    enum COMPRESSION : uint8_t {
+        COMPRESSION_NONE = 0,
+        COMPRESSION_GZIP,
+        COMPRESSION_ZSTD
+    };
+
+    constexpr size_t COMPRESSION_MAGIC_WIDTH = 4U;
+
+    inline COMPRESSION DETECT_COMPRESSION(
+        std::span<const uint8_t> prefix) noexcept {
+        constexpr std::array<uint8_t, 2> GZIP_MAGIC = {0x1F, 0x8B};
+        constexpr std::array<uint8_t, 4> ZSTD_MAGIC = {0x28, 0xB5, 0x2F, 0xFD};
+
+        if (prefix.size() >= GZIP_MAGIC.size() &&
+            std::equal(GZIP_MAGIC.begin(), GZIP_MAGIC.end(), prefix.begin())) {
+            return COMPRESSION_GZIP;
+        }
+        if (prefix.size() >= ZSTD_MAGIC.size() &&
+            std::equal(ZSTD_MAGIC.begin(), ZSTD_MAGIC.end(), prefix.begin())) {
+            return COMPRESSION_ZSTD;
+        }
+        return COMPRESSION_NONE;
+    }
+
+    // Sniffs the magic bytes of `upstream` and wraps it in the matching
+    // decompressor. With `prefetch`, decompression runs on a second thread.
+    inline std::unique_ptr<ByteSource> OPEN_DECOMPRESSOR(
+        std::unique_ptr<ByteSource> upstream, bool prefetch = true) {
+        std::vector<uint8_t> prefix(COMPRESSION_MAGIC_WIDTH);
+        size_t filled = 0U;
+        while (filled < prefix.size()) {
+            const size_t count =
+                upstream->read(std::span<uint8_t>(prefix).subspan(filled));
+            if (count == 0U) {
+                break;
+            }
+            filled += count;
+        }
+        prefix.resize(filled);
+
+        const COMPRESSION compression = DETECT_COMPRESSION(prefix);
+        std::unique_ptr<ByteSource> source =
+            std::make_unique<PrefixedByteSource>(std::move(prefix),
+                                                 std::move(upstream));
+
+        switch (compression) {
+            case COMPRESSION_GZIP:
+#if NNIST_HAS_ZLIB
+                source = std::make_unique<GzipByteSource>(std::move(source));
+                break;
+#else
+                throw std::runtime_error("gzip input requires zlib");
+#endif
+            case COMPRESSION_ZSTD:
+#if NNIST_HAS_ZSTD
+                source = std::make_unique<ZstdByteSource>(std::move(source));
+                break;
+#else
+                throw std::runtime_error("zstd input requires libzstd");
+#endif
+            case COMPRESSION_NONE:
+                return source;
+        }
+
+        if (prefetch) {
+            source = std::make_unique<ThreadedByteSource>(std::move(source));
+        }
+        return source;
+    }
+
+    inline std::unique_ptr<ByteSource> OPEN_INPUT(
+        const std::filesystem::path& path, bool prefetch = true) {
+        return OPEN_DECOMPRESSOR(std::make_unique<FileByteSource>(path),
+                                 prefetch);
+    }
+
+    // --------------------------------------------
+    // Record Stream (Bounded Window)
+    // --------------------------------------------
+    // Parses records one at a time from a ByteSource. Only the record being
+    // parsed (plus one chunk of read-ahead) is held in memory, so the window
+    // is bounded by the largest single record, not by the transaction.
+    // Concatenated transactions are read back to back; each starts with its
+    // Type-1 record.
+    class RecordStream {
+      public:
+        explicit RecordStream(ByteSource& source,
+                              size_t chunk_size = DEFAULT_STREAM_CHUNK)
+            : source_(source), chunk_size_(chunk_size) {}
+
+        // Returns false at a clean end of input.
+        bool next(Record& record) {
+            record = Record{};
+            skip_separators();
+
+            if (pending_.empty()) {
+                if (!fill(1U)) {
+                    return false;
+                }
+                const size_t length = read_tagged(record);
+                record.type = RECORD_TYPE_1;
+                record.idc = -1;
+
+                const PARSE_STATUS status = FOR_EACH_CNT_ENTRY(
+                    view().first(length), [this](int record_type, int idc) {
+                        pending_.emplace_back(record_type, idc);
+                        return true;
+                    });
+                start_ += length;
+                if (status != PARSE_OK) {
+                    throw std::runtime_error(PARSE_STATUS_MESSAGE(status));
+                }
+                return true;
+            }
+
+            const auto [record_type, idc] = pending_.front();
+            pending_.pop_front();
+
+            if (!fill(4U)) {
+                pending_.clear();
+                throw std::runtime_error(PARSE_STATUS_MESSAGE(PARSE_TRUNCATED));
+            }
+
+            if (IS_LEGACY_BINARY_TYPE(record_type)) {
+                read_binary(record, record_type);
+            } else {
+                start_ += read_tagged(record);
+            }
+            record.type = record_type;
+            record.idc = idc;
+            return true;
+        }
+
+        // Size of the largest window held so far.
+        [[nodiscard]] size_t peak_window() const noexcept {
+            return peak_window_;
+        }
+
+      private:
+        [[nodiscard]] size_t available() const noexcept {
+            return window_.size() - start_;
+        }
+
+        [[nodiscard]] std::span<const uint8_t> view() const noexcept {
+            return std::span<const uint8_t>(window_).subspan(start_);
+        }
+
+        bool fill(size_t needed) {
+            while (available() < needed) {
+                if (start_ > 0U) {
+                    window_.erase(
+                        window_.begin(),
+                        window_.begin() + static_cast<ptrdiff_t>(start_));
+                    start_ = 0U;
+                }
+                const size_t old_size = window_.size();
+                window_.resize(old_size +
+                               std::max(chunk_size_, needed - old_size));
+                const size_t count = source_.read(
+                    std::span<uint8_t>(window_).subspan(old_size));
+                window_.resize(old_size + count);
+                peak_window_ = std::max(peak_window_, window_.capacity());
+                if (count == 0U) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void skip_separators() {
+            while (fill(1U) &&
+                   (window_[start_] == FS || window_[start_] == GS)) {
+                ++start_;
+            }
+        }
+
+        // Parses the tagged record at the window start and returns its LEN;
+        // the caller consumes it.
+        size_t read_tagged(Record& record) {
+            fill(MAX_TAGGED_HEADER_WIDTH);
+
+            int tagged_type = -1;
+            size_t length = 0U;
+            if (!READ_TAGGED_HEADER(view(), 0U, tagged_type, length)) {
+                throw std::runtime_error(
+                    PARSE_STATUS_MESSAGE(PARSE_INVALID_TAGGED_LEN));
+            }
+            if (!fill(length)) {
+                throw std::runtime_error(PARSE_STATUS_MESSAGE(PARSE_TRUNCATED));
+            }
+
+            Cursor cursor{view().first(length)};
+            PARSE_RECORD_INTO(cursor, record);
+            return length;
+        }
+
+        void read_binary(Record& record, int record_type) {
+            const uint32_t length = READ_BE_U32(view().first(4U));
+            if (length < MIN_BINARY_RECORD_SIZE || !fill(length)) {
+                throw std::runtime_error(
+                    PARSE_STATUS_MESSAGE(PARSE_INVALID_BINARY_LEN));
+            }
+
+            Cursor cursor{view().first(length)};
+            const PARSE_STATUS status =
+                PARSE_BINARY_RECORD_INTO(cursor, record_type, record);
+            if (status != PARSE_OK) {
+                throw std::runtime_error(PARSE_STATUS_MESSAGE(status));
+            }
+            start_ += length;
+        }
+
+        ByteSource& source_;
+        size_t chunk_size_;
+        std::vector<uint8_t> window_;
+        size_t start_ = 0U;
+        size_t peak_window_ = 0U;
+        std::deque<std::pair<int, int>> pending_;
+    };
+
+    // Reads one transaction (the first in the stream) into a File.
+    inline File PARSE_STREAM(ByteSource& source) {
+        RecordStream stream(source);
+        File file;
+        Record record;
+
+        if (!stream.next(record)) {
+            return file;
+        }
+        file.records.push_back(std::move(record));
+        const size_t planned = PARSE_CNT_PLAN(file.records[0]).size();
+
+        while (file.records.size() <= planned && stream.next(record)) {
+            file.records.push_back(std::move(record));
+        }
+        return file;
+    }
+
+    inline File PARSE_COMPRESSED_FILE(const std::filesystem::path& path) {
+        auto source = OPEN_INPUT(path);
+        return PARSE_STREAM(*source);
+    }
+
+}  // namespace nnist
+#endif
@@ -0,0 +1,250 @@
+#pragma once
+#include "nnist/constants.h"
+
+#if !NNIST_FREESTANDING
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "nnist/parallel.h"
+#include "nnist/parsers.h"
+#include "nnist/scan.h"
+#include "nnist/types.h"
+
+namespace nnist {
+
+    constexpr size_t TYPE9_FMT_FIELD = 4U;   // 9.004 FMT ('S' = standard)
+    constexpr size_t TYPE9_NMN_FIELD = 10U;  // 9.010 number of minutiae
+    constexpr size_t TYPE9_MRC_FIELD = 12U;  // 9.012 minutiae/ridge counts
+    constexpr size_t THETA_WIDTH = 3U;
+
+    enum MINUTIAE_STATUS : uint8_t {
+        MINUTIAE_OK = 0,
+        MINUTIAE_NOT_TYPE9,
+        MINUTIAE_NOT_STANDARD,  // 9.004 is not 'S' (user-defined format)
+        MINUTIAE_NO_DATA,       // no 9.012 field
+        MINUTIAE_MALFORMED
+    };
+
+    // --------------------------------------------
+    // Minutiae (Structure of Arrays)
+    // --------------------------------------------
+    // One entry per minutia across every decoded record. Minutiae of record
+    // r live in [record_offsets[r], record_offsets[r + 1]).
+    struct MinutiaeSoA {
+        std::vector<uint32_t> x;      // 0.01 mm units
+        std::vector<uint32_t> y;      // 0.01 mm units
+        std::vector<uint16_t> theta;  // degrees
+        std::vector<uint8_t> quality;
+        std::vector<uint8_t> type;  // 'A' ending, 'B' bifurcation, 'C', 'D'
+        std::vector<size_t> record_offsets{0U};
+        std::vector<MINUTIAE_STATUS> record_status;
+
+        [[nodiscard]] size_t size() const noexcept { return x.size(); }
+
+        void resize(size_t count) {
+            x.resize(count);
+            y.resize(count);
+            theta.resize(count);
+            quality.resize(count);
+            type.resize(count);
+        }
+    };
+
+    // Decimal value of `width` ASCII digits; callers check ALL_DIGITS first.
+    inline uint32_t PARSE_FIXED_DIGITS(const uint8_t* bytes,
+                                       size_t width) noexcept {
+        constexpr uint32_t DECIMAL_BASE = 10U;
+        uint32_t value = 0U;
+        for (size_t i = 0; i < width; i++) {
+            value = value * DECIMAL_BASE +
+                    static_cast<uint32_t>(bytes[i] - static_cast<uint8_t>('0'));
+        }
+        return value;
+    }
+
+    inline bool ALL_DIGITS(std::span<const uint8_t> bytes) noexcept {
+        for (const uint8_t digit : bytes) {
+            if (digit < '0' || digit > '9') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Locates the raw 9.012 value of a standard-format Type-9 record.
+    inline MINUTIAE_STATUS FIND_MINUTIAE_FIELD(
+        std::span<const uint8_t> record, std::span<const uint8_t>& value) {
+        bool is_type9 = false;
+        bool standard = false;
+        bool found = false;
+
+        const PARSE_STATUS status =
+            FOR_EACH_TAGGED_FIELD(record, [&](const TaggedField& field) {
+                is_type9 = field.record_type == RECORD_TYPE_9;
+                if (!is_type9) {
+                    return false;
+                }
+                if (field.field_number == TYPE9_FMT_FIELD) {
+                    standard = field.value.size() == 1U &&
+                               field.value[0] == static_cast<uint8_t>('S');
+                } else if (field.field_number == TYPE9_MRC_FIELD) {
+                    value = field.value;
+                    found = true;
+                    return false;
+                }
+                return true;
+            });
+
+        if (status != PARSE_OK) {
+            return MINUTIAE_MALFORMED;
+        }
+        if (!is_type9) {
+            return MINUTIAE_NOT_TYPE9;
+        }
+        if (!standard) {
+            return MINUTIAE_NOT_STANDARD;
+        }
+        return found ? MINUTIAE_OK : MINUTIAE_NO_DATA;
+    }
+
+    inline size_t COUNT_MINUTIAE(std::span<const uint8_t> value) noexcept {
+        if (value.empty()) {
+            return 0U;
+        }
+        size_t count = 1U;
+        for (const uint8_t byte : value) {
+            count += byte == RS ? 1U : 0U;
+        }
+        return count;
+    }
+
+    // Decodes each 9.012 subfield (index, XYT, quality, type, ...) into the
+    // SoA slots starting at `first`. XYT is "<X><Y><theta>" with a 3-digit
+    // theta and X/Y of equal width (4 digits per ANSI/NIST-ITL 1-2007, 5 in
+    // some older encoders).
+    inline MINUTIAE_STATUS DECODE_MINUTIAE_AT(std::span<const uint8_t> value,
+                                              MinutiaeSoA& out,
+                                              size_t first) noexcept {
+        size_t index = first;
+        size_t position = 0U;
+
+        while (position < value.size()) {
+            const size_t subfield_end = FIND_DELIMITER(value, position, RS, RS);
+            const auto subfield =
+                value.subspan(position, subfield_end - position);
+            position = subfield_end + 1U;
+
+            std::span<const uint8_t> items[4];
+            size_t item = 0U;
+            size_t start = 0U;
+            while (item < 4U && start <= subfield.size()) {
+                const size_t end = FIND_DELIMITER(subfield, start, US, US);
+                items[item++] = subfield.subspan(start, end - start);
+                start = end + 1U;
+            }
+            if (item < 4U) {
+                return MINUTIAE_MALFORMED;
+            }
+
+            const auto xyt = items[1];
+            const size_t coordinate_width =
+                xyt.size() > THETA_WIDTH ? (xyt.size() - THETA_WIDTH) / 2U : 0U;
+            if (coordinate_width == 0U ||
+                coordinate_width * 2U + THETA_WIDTH != xyt.size() ||
+                !ALL_DIGITS(xyt) || items[2].empty() ||
+                !ALL_DIGITS(items[2]) || items[3].size() != 1U) {
+                return MINUTIAE_MALFORMED;
+            }
+
+            out.x[index] = PARSE_FIXED_DIGITS(xyt.data(), coordinate_width);
+            out.y[index] = PARSE_FIXED_DIGITS(xyt.data() + coordinate_width,
+                                              coordinate_width);
+            out.theta[index] = static_cast<uint16_t>(PARSE_FIXED_DIGITS(
+                xyt.data() + 2U * coordinate_width, THETA_WIDTH));
+            out.quality[index] = static_cast<uint8_t>(
+                PARSE_FIXED_DIGITS(items[2].data(), items[2].size()));
+            out.type[index] = items[3][0];
+            ++index;
+        }
+
+        return MINUTIAE_OK;
+    }
+
+    // Appends the minutiae of one Type-9 record (its exact LEN span).
+    inline MINUTIAE_STATUS DECODE_MINUTIAE(std::span<const uint8_t> record,
+                                           MinutiaeSoA& out) {
+        std::span<const uint8_t> value;
+        MINUTIAE_STATUS status = FIND_MINUTIAE_FIELD(record, value);
+
+        const size_t first = out.size();
+        if (status == MINUTIAE_OK) {
+            out.resize(first + COUNT_MINUTIAE(value));
+            status = DECODE_MINUTIAE_AT(value, out, first);
+            if (status != MINUTIAE_OK) {
+                out.resize(first);
+            }
+        }
+
+        out.record_offsets.push_back(out.size());
+        out.record_status.push_back(status);
+        return status;
+    }
+
+    // Decodes many Type-9 records in two parallel passes: count minutiae per
+    // record, size every array once by prefix sum, then decode each record
+    // into its own slice. Records that fail contribute no minutiae.
+    inline MinutiaeSoA DECODE_MINUTIAE_BATCH(
+        const std::vector<std::span<const uint8_t>>& records,
+        size_t thread_count = 0U) {
+        const size_t count = records.size();
+        std::vector<std::span<const uint8_t>> values(count);
+
+        MinutiaeSoA out;
+        out.record_status.resize(count);
+        out.record_offsets.assign(count + 1U, 0U);
+
+        PARALLEL_FOR(count, thread_count, [&](size_t i) {
+            out.record_status[i] = FIND_MINUTIAE_FIELD(records[i], values[i]);
+            out.record_offsets[i + 1U] = out.record_status[i] == MINUTIAE_OK
+                                             ? COUNT_MINUTIAE(values[i])
+                                             : 0U;
+        });
+        for (size_t i = 0; i < count; i++) {
+            out.record_offsets[i + 1U] += out.record_offsets[i];
+        }
+        out.resize(out.record_offsets.back());
+
+        PARALLEL_FOR(count, thread_count, [&](size_t i) {
+            if (out.record_status[i] == MINUTIAE_OK) {
+                out.record_status[i] =
+                    DECODE_MINUTIAE_AT(values[i], out, out.record_offsets[i]);
+            }
+        });
+
+        // Malformed records only surface while decoding; squeeze out their
+        // reserved slots so offsets stay contiguous.
+        size_t write = 0U;
+        for (size_t i = 0; i < count; i++) {
+            const size_t begin = out.record_offsets[i];
+            const size_t end = out.record_offsets[i + 1U];
+            out.record_offsets[i] = write;
+            if (out.record_status[i] != MINUTIAE_OK) {
+                continue;
+            }
+            for (size_t m = begin; m < end && write != begin; m++) {
+                out.x[write + m - begin] = out.x[m];
+                out.y[write + m - begin] = out.y[m];
+                out.theta[write + m - begin] = out.theta[m];
+                out.quality[write + m - begin] = out.quality[m];
+                out.type[write + m - begin] = out.type[m];
+            }
+            write += end - begin;
+        }
+        out.record_offsets[count] = write;
+        out.resize(write);
+        return out;
+    }
+
+}  // namespace nnist
+#endif
@@ -1,9 +1,8 @@
 #pragma once
 #include <cstdint>
-#include <stdexcept>
-#include <string>
-#include <string_view>
-#include <vector>
+
+#include "nnist/constants.h"
+#include "nnist/storage.h"
 
 namespace nnist {
     enum DELIM : uint8_t {
@@ -13,28 +12,153 @@ namespace nnist {
         US = 0x1F   // Unit Separator (Ends an Item)
     };
 
-    struct Item {
-        std::vector<uint8_t> bytes;
+    template <typename Storage>
+    struct BasicItem {
+        typename Storage::Bytes bytes;
     };
-    struct Subfield {
-        std::vector<Item> items;
+    template <typename Storage>
+    struct BasicSubfield {
+        typename Storage::template ItemList<BasicItem<Storage>> items;
     };
-    struct Field {
+    template <typename Storage>
+    struct BasicField {
         bool is_binary_field = false;
-        std::vector<uint8_t> raw_field;
-        std::vector<uint8_t> tag;
-        std::vector<Subfield> subfields;
+        typename Storage::Bytes raw_field;
+        typename Storage::Bytes tag;
+        typename Storage::template SubfieldList<BasicSubfield<Storage>>
+            subfields;
     };
-    struct Record {
+    template <typename Storage>
+    struct BasicRecord {
         int type = -1;
         int idc = -1;
         bool is_binary_record =
             false;  // legacy/binary record (Type 3-6, 8, etc.)
-        std::vector<uint8_t>
+        typename Storage::Bytes
             raw_record;  // EXACT bytes of the record when binary
-        std::vector<Field> fields;
+        typename Storage::template FieldList<BasicField<Storage>> fields;
+
+        // LEN-governed byte range this record was parsed from, so unchanged
+        // records can be re-emitted verbatim. INVALID_INDEX when unknown.
+        // The range indexes the buffer starting at `source_base` only, and
+        // only while those bytes still hash to `source_hash`.
+        const uint8_t* source_base = nullptr;
+        size_t source_offset = INVALID_INDEX;
+        size_t source_length = 0U;
+        uint64_t source_hash = 0U;
+        bool dirty = false;  // set when edited; forces regeneration
     };
-    struct File {
-        std::vector<Record> records;
+
+    constexpr size_t TYPE1_LEN_FIELD = 1U;  // 1.001 record length
+    constexpr size_t TYPE1_VER_FIELD = 2U;  // 1.002 version
+    constexpr size_t TYPE1_CNT_FIELD = 3U;  // 1.003 file content
+    constexpr size_t TYPE1_TOT_FIELD = 4U;  // 1.004 type of transaction
+    constexpr size_t TYPE1_DAT_FIELD = 5U;  // 1.005 date
+    constexpr size_t TYPE1_ORI_FIELD = 8U;  // 1.008 originating agency
+    constexpr size_t TYPE1_TCN_FIELD = 9U;  // 1.009 control number
+
+    // Indexes into the Type-1 record's fields of its header fields, as
+    // tokenized. INVALID_INDEX when a field is absent.
+    struct Type1Fields {
+        size_t len = INVALID_INDEX;
+        size_t ver = INVALID_INDEX;
+        size_t cnt = INVALID_INDEX;
+        size_t tot = INVALID_INDEX;
+        size_t dat = INVALID_INDEX;
+        size_t ori = INVALID_INDEX;
+        size_t tcn = INVALID_INDEX;
+
+        // Member tracking field 1.<number>; nullptr for untracked fields.
+        static constexpr size_t Type1Fields::*member(size_t number) noexcept {
+            switch (number) {
+                case TYPE1_LEN_FIELD:
+                    return &Type1Fields::len;
+                case TYPE1_VER_FIELD:
+                    return &Type1Fields::ver;
+                case TYPE1_CNT_FIELD:
+                    return &Type1Fields::cnt;
+                case TYPE1_TOT_FIELD:
+                    return &Type1Fields::tot;
+                case TYPE1_DAT_FIELD:
+                    return &Type1Fields::dat;
+                case TYPE1_ORI_FIELD:
+                    return &Type1Fields::ori;
+                case TYPE1_TCN_FIELD:
+                    return &Type1Fields::tcn;
+                default:
+                    return nullptr;
+            }
+        }
+
+        // Index of field 1.<number>, or INVALID_INDEX when it is absent or
+        // not tracked.
+        [[nodiscard]] size_t at(size_t number) const noexcept {
+            const auto tracked = member(number);
+            return tracked == nullptr ? INVALID_INDEX : this->*tracked;
+        }
+
+        // Records field `index` as 1.<number>; the first occurrence wins.
+        void note(size_t index, size_t number) noexcept {
+            const auto tracked = member(number);
+            if (tracked != nullptr && this->*tracked == INVALID_INDEX) {
+                this->*tracked = index;
+            }
+        }
     };
+
+    template <typename Storage>
+    struct BasicFile {
+        typename Storage::template RecordList<BasicRecord<Storage>> records;
+        // Type-1 header field positions, set by PARSE_FILE_INTO. They are
+        // not updated when records[0].fields is edited.
+        Type1Fields type1;
+    };
+
+    // Element pools of a FixedStorage File. PoolList / PoolRoot call
+    // attach() on every new element so its child list draws from here.
+    template <typename Storage>
+    struct FixedPools {
+        InlineVector<BasicField<Storage>, Storage::FIELD_CAPACITY> fields;
+        InlineVector<BasicSubfield<Storage>, Storage::SUBFIELD_CAPACITY>
+            subfields;
+        InlineVector<BasicItem<Storage>, Storage::ITEM_CAPACITY> items;
+
+        auto& pool(BasicField<Storage>*) noexcept { return fields; }
+        auto& pool(BasicSubfield<Storage>*) noexcept { return subfields; }
+        auto& pool(BasicItem<Storage>*) noexcept { return items; }
+        const auto& pool(const BasicField<Storage>*) const noexcept {
+            return fields;
+        }
+        const auto& pool(const BasicSubfield<Storage>*) const noexcept {
+            return subfields;
+        }
+        const auto& pool(const BasicItem<Storage>*) const noexcept {
+            return items;
+        }
+
+        void attach(BasicRecord<Storage>& record) noexcept {
+            record.fields.attach(this);
+        }
+        void attach(BasicField<Storage>& field) noexcept {
+            field.subfields.attach(this);
+        }
+        void attach(BasicSubfield<Storage>& subfield) noexcept {
+            subfield.items.attach(this);
+        }
+        void attach(BasicItem<Storage>&) noexcept {}
+
+        void clear() noexcept {
+            fields.clear();
+            subfields.clear();
+            items.clear();
+        }
+    };
+
+#if !NNIST_FREESTANDING
+    using Item = BasicItem<HeapStorage>;
+    using Subfield = BasicSubfield<HeapStorage>;
+    using Field = BasicField<HeapStorage>;
+    using Record = BasicRecord<HeapStorage>;
+    using File = BasicFile<HeapStorage>;
+#endif
 }  // namespace nnist
@@ -0,0 +1,104 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+#include <string>
+
+using namespace nnist;
+
+static std::vector<uint8_t> SAMPLE(const std::string& name) {
+    return READ_FILE(std::string(TEST_DIR "data/") + name + ".an2");
+}
+
+TEST(NIST_ParseCache_Repeat_Submission_Hits) {
+    auto data = SAMPLE("valid1.11");
+    auto copy = data;  // same bytes, different buffer
+    ParseCache cache(size_t{64} << 20U);
+
+    const auto first = cache.parse(data);
+    const auto second = cache.parse(copy);
+    ASSERT_EQ(first.get(), second.get());
+    ASSERT_EQ(first->file.records.size(), PARSE_FILE(data).records.size());
+
+    const auto stats = cache.stats();
+    ASSERT_EQ(stats.hits, 1U);
+    ASSERT_EQ(stats.misses, 1U);
+    ASSERT_EQ(stats.entries, 1U);
+    ASSERT_EQ(stats.bytes, FILE_FOOTPRINT(first->file) + data.size());
+
+    copy[copy.size() - 1U] ^= 1U;
+    ASSERT_TRUE(cache.find(copy) == nullptr);
+}
+
+TEST(NIST_ParseCache_Evicts_Least_Recently_Used) {
+    auto a = SAMPLE("valid1.1");
+    auto b = SAMPLE("valid1.2");
+    auto c = SAMPLE("valid1.3");
+    const size_t fa = FILE_FOOTPRINT(PARSE_FILE(a)) + a.size();
+    const size_t fb = FILE_FOOTPRINT(PARSE_FILE(b)) + b.size();
+    const size_t fc = FILE_FOOTPRINT(PARSE_FILE(c)) + c.size();
+
+    // Room for any two of the three, never all three.
+    ParseCache cache(std::max({fa + fb, fa + fc, fb + fc}), 1U);
+
+    const auto kept = cache.parse(a);
+    cache.parse(b);
+    ASSERT_TRUE(cache.find(a) != nullptr);  // a is now most recent
+    cache.parse(c);
+    ASSERT_TRUE(cache.find(b) == nullptr);
+    ASSERT_TRUE(cache.find(a) != nullptr);
+    ASSERT_EQ(cache.stats().evictions, 1U);
+    ASSERT_TRUE(kept->file.records.size() > 0U);  // still alive after eviction
+}
+
+TEST(NIST_ParseCache_Oversized_Result_Is_Not_Cached) {
+    auto data = SAMPLE("valid1.11");
+    ParseCache cache(16U, 1U);
+    const auto file = cache.parse(data);
+    ASSERT_TRUE(file != nullptr);
+    ASSERT_EQ(cache.stats().entries, 0U);
+    ASSERT_EQ(cache.stats().bytes, 0U);
+}
+
+TEST(NIST_ParseCache_Concurrent_Lookups_Share_Results) {
+    const std::vector<std::vector<uint8_t>> inputs = {
+        SAMPLE("valid1.1"), SAMPLE("valid1.8"), SAMPLE("valid1.11"),
+        SAMPLE("type_3_wvu")};
+    ParseCache cache(size_t{64} << 20U, 4U);
+
+    constexpr size_t LOOKUPS = 256U;
+    std::vector<std::shared_ptr<const CachedTransaction>> results(LOOKUPS);
+    PARALLEL_FOR(LOOKUPS, 8U, [&](size_t i) {
+        results[i] = cache.parse(inputs[i % inputs.size()]);
+    });
+
+    for (size_t i = 0; i < LOOKUPS; i++) {
+        const auto expected = cache.find(inputs[i % inputs.size()]);
+        ASSERT_EQ(results[i].get(), expected.get());
+    }
+    const auto stats = cache.stats();
+    ASSERT_EQ(stats.entries, inputs.size());
+    ASSERT_EQ(stats.hits + stats.misses, LOOKUPS + LOOKUPS);
+    ASSERT_TRUE(stats.misses >= inputs.size());
+}
+
+TEST(NIST_ParseCache_Result_Owns_Its_Source) {
+    const auto path = std::string(TEST_DIR "data/valid1.11.an2");
+    const auto data = READ_FILE(path);
+    ParseCache cache(size_t{64} << 20U);
+
+    // The read buffer is gone once read() returns; the result's spans
+    // index the bytes it keeps instead.
+    const auto result = cache.read(path);
+    ASSERT_EQ(result->bytes, data);
+    for (const auto& record : result->file.records) {
+        ASSERT_TRUE(IS_CLEAN_RECORD(record, result->bytes));
+    }
+
+    // A hit from another buffer shares the same result and source.
+    const auto hit = cache.parse(data);
+    ASSERT_EQ(hit.get(), result.get());
+    File copy = hit->file;
+    auto segments = SERIALIZE_FILE_SEGMENTS(copy, hit->bytes);
+    ASSERT_TRUE(segments.owned.empty());
+    ASSERT_EQ(segments.flatten(), data);
+}
@@ -0,0 +1,109 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+#include <string>
+
+using namespace nnist;
+
+static std::vector<uint8_t> BYTES(const std::string& text) {
+    return {text.begin(), text.end()};
+}
+
+TEST(NIST_Charset_Detects_DCS_Encoding) {
+    MappedFile mapped(TEST_DIR "data/face_jpb_DOM_GMT_DCS.an2");
+    RecordLocator locator(mapped.bytes());
+    ASSERT_EQ(DETECT_TEXT_ENCODING(locator.bytes(locator.at(0))), TEXT_ASCII);
+
+    MappedFile plain(TEST_DIR "data/valid1.11.an2");
+    RecordLocator plain_locator(plain.bytes());
+    ASSERT_EQ(DETECT_TEXT_ENCODING(plain_locator.bytes(plain_locator.at(0))),
+              TEXT_ASCII);
+
+    const auto latin = BYTES("1.001:30\x1D" "1.015:1\x1FLATIN\x1F\x1C");
+    ASSERT_EQ(DETECT_TEXT_ENCODING(latin), TEXT_LATIN1);
+}
+
+TEST(NIST_Charset_Validates_UTF8) {
+    // Long enough that the invalid byte lies beyond the first SIMD block.
+    const auto valid = BYTES("2.018:M\xC3\xBCller-\xE2\x82\xAC-\xF0\x9F\x98\x80"
+                             "-ascii-tail-0123456789\x1C");
+    ASSERT_EQ(FIND_INVALID_UTF8(valid), valid.size());
+    ASSERT_TRUE(!IS_ASCII(valid));
+
+    const auto overlong = BYTES("2.018:padding-padding-padding\xC0\xAF\x1C");
+    ASSERT_EQ(FIND_INVALID_UTF8(overlong), 29U);
+
+    const auto surrogate = BYTES("2.018:\xED\xA0\x80\x1C");
+    ASSERT_EQ(FIND_INVALID_UTF8(surrogate), 6U);
+
+    const auto truncated = BYTES("2.018:\xE2\x82");
+    ASSERT_EQ(FIND_INVALID_UTF8(truncated), 6U);
+}
+
+TEST(NIST_Charset_Transcodes_Records_Into_One_Arena) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    RecordLocator locator(data);
+    const auto ascii = locator.bytes(*locator.find(2, 0));
+    ASSERT_TRUE(IS_ASCII(ascii));
+
+    const auto latin = BYTES("2.001:29\x1D" "2.018:M\xFCller,J\xE9r\xF4me\x1C");
+    const auto utf8 =
+        BYTES("2.001:32\x1D" "2.018:M\xC3\xBCller,J\xC3\xA9r\xC3\xB4me\x1C");
+
+    std::vector<uint8_t> arena;
+    const auto to_utf8 = TRANSCODE_RECORDS({ascii, latin, latin}, TEXT_LATIN1,
+                                           TEXT_UTF8, arena);
+    ASSERT_EQ(to_utf8.size(), 3U);
+    ASSERT_EQ(to_utf8[0].status, TEXT_OK);
+    ASSERT_TRUE(to_utf8[0].text.data() == ascii.data());  // not copied
+    ASSERT_EQ(arena.size(), 2U * utf8.size());
+    ASSERT_EQ(to_utf8[1].view(),
+              std::string_view(reinterpret_cast<const char*>(utf8.data()),
+                               utf8.size()));
+    ASSERT_EQ(to_utf8[2].view(), to_utf8[1].view());
+
+    const auto to_latin =
+        TRANSCODE_RECORDS({utf8}, TEXT_UTF8, TEXT_LATIN1, arena);
+    ASSERT_EQ(to_latin[0].status, TEXT_OK);
+    ASSERT_TRUE(std::equal(latin.begin(), latin.end(),
+                           to_latin[0].text.begin(), to_latin[0].text.end()));
+
+    const auto euro = BYTES("2.018:\xE2\x82\xAC\x1C");
+    const auto failed =
+        TRANSCODE_RECORDS({euro, latin}, TEXT_UTF8, TEXT_LATIN1, arena);
+    ASSERT_EQ(failed[0].status, TEXT_UNREPRESENTABLE);
+    ASSERT_EQ(failed[0].error_offset, 6U);
+    ASSERT_EQ(failed[1].status, TEXT_INVALID_UTF8);
+}
+
+// The LEN of a transcoded record matches its new size, including when the
+// LEN gains a digit.
+TEST(NIST_Charset_Transcoding_Rewrites_LEN) {
+    const std::string body = "2.018:" + std::string(78U, 'a') +
+                             "\xE9\xE8\xEA\xEB\xFC" "\x1C";
+    const auto latin = BYTES("2.001:99\x1D" + body);
+    ASSERT_EQ(latin.size(), 99U);
+
+    std::vector<uint8_t> arena;
+    const auto to_utf8 =
+        TRANSCODE_RECORDS({latin}, TEXT_LATIN1, TEXT_UTF8, arena);
+    ASSERT_EQ(to_utf8[0].status, TEXT_OK);
+    ASSERT_EQ(to_utf8[0].text.size(), 105U);  // +5 bytes, +1 LEN digit
+
+    int record_type = -1;
+    size_t length = 0U;
+    ASSERT_TRUE(READ_TAGGED_HEADER(to_utf8[0].text, 0U, record_type, length));
+    ASSERT_EQ(record_type, 2);
+    ASSERT_EQ(length, to_utf8[0].text.size());
+    Cursor cursor{to_utf8[0].text};
+    const Record record = PARSE_RECORD(cursor);
+    ASSERT_EQ(record.fields.size(), 2U);
+    ASSERT_EQ(PARSE_LEN_FROM_FIRST_FIELD(record.fields[0]), 105U);
+
+    const std::vector<uint8_t> utf8(to_utf8[0].text.begin(),
+                                    to_utf8[0].text.end());
+    const auto back = TRANSCODE_RECORDS({utf8}, TEXT_UTF8, TEXT_LATIN1, arena);
+    ASSERT_EQ(back[0].status, TEXT_OK);
+    ASSERT_TRUE(std::equal(latin.begin(), latin.end(), back[0].text.begin(),
+                           back[0].text.end()));
+}
@@ -0,0 +1,137 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+#include <set>
+#include <string>
+
+using namespace nnist;
+
+static bool POINTS_INTO(std::span<const uint8_t> segment,
+                        const std::vector<uint8_t>& source) {
+    return segment.data() >= source.data() &&
+           segment.data() + segment.size() <= source.data() + source.size();
+}
+
+TEST(NIST_Compose_Merge_Renumbers_Colliding_Idcs) {
+    auto first = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    auto second = READ_FILE(TEST_DIR "data/valid1.8.an2");
+
+    const auto merged = MERGE_TRANSACTIONS({first, second});
+    auto bytes = merged.flatten();
+    auto file = PARSE_FILE(bytes);
+
+    const RecordLocator left(first);
+    const RecordLocator right(second);
+    ASSERT_EQ(file.records.size(), left.size() + right.size() - 1U);
+    ASSERT_TRUE(CNT_MATCHES_RECORDS(file));
+
+    std::set<int> idcs;
+    for (size_t i = 1; i < file.records.size(); i++) {
+        idcs.insert(file.records[i].idc);
+    }
+    ASSERT_EQ(idcs.size(), file.records.size() - 1U);
+
+    // The first transaction keeps its IDCs; the second moves past them.
+    ASSERT_EQ(file.records[1].idc, 0);
+    ASSERT_EQ(file.records[left.size()].idc, 9);
+    ASSERT_EQ(file.records.back().idc, 12);
+}
+
+TEST(NIST_Compose_Merge_Passes_Payloads_Through) {
+    auto first = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    auto second = READ_FILE(TEST_DIR "data/valid1.8.an2");
+
+    const auto merged = MERGE_TRANSACTIONS({first, second});
+    const auto images = LOCATE_IMAGES(second);
+    ASSERT_TRUE(!images.empty());
+
+    // Every renumbered Type-14 payload is a span of the source buffer.
+    size_t passed_through = 0U;
+    for (const auto& image : images) {
+        for (const auto& segment : merged.segments) {
+            if (segment.data() == second.data() + image.offset &&
+                segment.size() == image.length) {
+                ++passed_through;
+            }
+        }
+    }
+    ASSERT_EQ(passed_through, images.size());
+
+    // Untouched records of the first transaction are referenced verbatim.
+    const RecordLocator left(first);
+    for (size_t i = 1; i < left.size(); i++) {
+        ASSERT_TRUE(POINTS_INTO(merged.segments[i], first));
+        ASSERT_EQ(merged.segments[i].size(), left.at(i).length);
+    }
+}
+
+TEST(NIST_Compose_Split_Produces_Valid_Transactions) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    const RecordLocator locator(data);
+
+    const auto parts = SPLIT_TRANSACTION(data, {{1, 2, 3}, {4, 5, 6, 7}});
+    ASSERT_EQ(parts.size(), 2U);
+
+    auto head = parts[0].flatten();
+    auto tail = parts[1].flatten();
+    auto head_file = PARSE_FILE(head);
+    auto tail_file = PARSE_FILE(tail);
+    ASSERT_EQ(head_file.records.size(), 4U);
+    ASSERT_EQ(tail_file.records.size(), 5U);
+    ASSERT_TRUE(CNT_MATCHES_RECORDS(head_file));
+    ASSERT_TRUE(CNT_MATCHES_RECORDS(tail_file));
+    ASSERT_EQ(tail_file.records[1].type, locator.at(4).type);
+
+    // A split never renumbers, so every record is the source span.
+    for (size_t i = 1; i < parts[1].segments.size(); i++) {
+        const auto segment = parts[1].segments[i];
+        ASSERT_TRUE(POINTS_INTO(segment, data));
+        ASSERT_EQ(segment.data(), data.data() + locator.at(i + 3U).offset);
+    }
+}
+
+TEST(NIST_Compose_Renumbered_Tagged_Record_Roundtrips) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.8.an2");
+
+    const auto merged = MERGE_TRANSACTIONS({data, data});
+    auto bytes = merged.flatten();
+    auto file = PARSE_FILE(bytes);
+    ASSERT_EQ(file.records.size(), 9U);
+    ASSERT_TRUE(VALIDATE_INTEGRITY(bytes).empty());
+
+    // Each rewritten x.001 equals the bytes up to the next record.
+    const RecordLocator locator(bytes);
+    for (size_t i = 0; i < locator.size(); i++) {
+        const RecordSpan& span = locator.at(i);
+        const size_t next =
+            i + 1U < locator.size() ? locator.at(i + 1U).offset : bytes.size();
+        ASSERT_EQ(span.offset + span.length, next);
+        if (!span.is_binary_record) {
+            ASSERT_EQ(PARSE_LEN_FROM_FIRST_FIELD(file.records[i].fields[0]),
+                      span.length);
+        }
+    }
+}
+
+TEST(NIST_Compose_Tagged_Idcs_Stay_Two_Digits) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.8.an2");
+    const size_t per_copy = RecordLocator(data).size() - 1U;
+
+    // Enough copies to need IDCs past 99 if the pool were one byte wide.
+    const size_t fits = (MAX_TAGGED_IDC + 1U) / per_copy;
+    std::vector<std::span<const uint8_t>> copies(fits, data);
+    auto bytes = MERGE_TRANSACTIONS(copies).flatten();
+    ASSERT_TRUE(VALIDATE_INTEGRITY(bytes).empty());
+    for (const auto& record : PARSE_FILE(bytes).records) {
+        ASSERT_LE(record.idc, MAX_TAGGED_IDC);
+    }
+
+    copies.resize(fits * 2U, data);
+    bool threw = false;
+    try {
+        (void)MERGE_TRANSACTIONS(copies);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+}
@@ -0,0 +1,121 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+using namespace nnist;
+
+static Field* FIND_FIELD(Record& rec, const std::string& tag) {
+    for (auto& field : rec.fields) {
+        if (std::string(field.tag.begin(), field.tag.end()) == tag) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+TEST(NIST_COW_Unchanged_File_Is_Byte_Identical) {
+    std::filesystem::path in_dir = TEST_DIR "data";
+
+    for (auto& entry : std::filesystem::directory_iterator(in_dir)) {
+        auto data = READ_FILE(entry.path());
+        auto file = PARSE_FILE(data);
+
+        auto segments = SERIALIZE_FILE_SEGMENTS(file, data);
+
+        ASSERT_TRUE(segments.owned.empty());
+        ASSERT_EQ(segments.flatten(), data);
+    }
+}
+
+TEST(NIST_COW_Regenerates_Only_Dirty_Record) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    auto file = PARSE_FILE(data);
+
+    Record& type2 = EDIT_RECORD(file, 1);
+    Field* name = FIND_FIELD(type2, "2.018");
+    ASSERT_TRUE(name != nullptr);
+    const std::string new_name = "smith,thomas";
+    name->subfields[0].items[0].bytes = {new_name.begin(), new_name.end()};
+
+    auto segments = SERIALIZE_FILE_SEGMENTS(file, data);
+    ASSERT_EQ(segments.owned.size(), 1);
+
+    // Every other record is referenced straight from the source buffer.
+    for (size_t i = 0; i < file.records.size(); i++) {
+        if (i == 1) {
+            continue;
+        }
+        ASSERT_EQ(segments.segments[i].data(),
+                  data.data() + file.records[i].source_offset);
+    }
+
+    auto out = segments.flatten();
+    ASSERT_EQ(out.size(), data.size() + 3U);
+
+    auto reparsed = PARSE_FILE(out);
+    ASSERT_EQ(reparsed.records.size(), file.records.size());
+    Field* reparsed_name = FIND_FIELD(reparsed.records[1], "2.018");
+    ASSERT_TRUE(reparsed_name != nullptr);
+    ASSERT_EQ(reparsed_name->subfields[0].items[0].bytes,
+              std::vector<uint8_t>(new_name.begin(), new_name.end()));
+}
+
+TEST(NIST_COW_Record_List_Change_Rewrites_CNT) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.9.an2");
+    auto file = PARSE_FILE(data);
+    const size_t original_count = file.records.size();
+
+    file.records.pop_back();
+    ASSERT_TRUE(!CNT_MATCHES_RECORDS(file));
+
+    auto out = SERIALIZE_FILE(file, data);
+    auto reparsed = PARSE_FILE(out);
+
+    ASSERT_EQ(reparsed.records.size(), original_count - 1U);
+    for (size_t i = 0; i < reparsed.records.size(); i++) {
+        ASSERT_EQ(reparsed.records[i].type, file.records[i].type);
+        ASSERT_EQ(reparsed.records[i].idc, file.records[i].idc);
+    }
+}
+
+TEST(NIST_COW_Foreign_Record_Is_Regenerated) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    auto other_data = READ_FILE(TEST_DIR "data/valid1.9.an2");
+    auto file = PARSE_FILE(data);
+    const auto other = PARSE_FILE(other_data);
+
+    // Same type, IDC and span shape as far as the record knows, but its
+    // offsets index `other_data`, not `data`.
+    file.records.push_back(other.records[1]);
+    const Record& foreign = file.records.back();
+    ASSERT_TRUE(!IS_CLEAN_RECORD(foreign, data));
+    ASSERT_TRUE(IS_CLEAN_RECORD(foreign, other_data));
+
+    auto segments = SERIALIZE_FILE_SEGMENTS(file, data);
+    const auto& emitted = segments.segments.back();
+    const auto expected = std::span<const uint8_t>(other_data)
+                              .subspan(foreign.source_offset,
+                                       foreign.source_length);
+    ASSERT_TRUE(std::equal(emitted.begin(), emitted.end(), expected.begin(),
+                           expected.end()));
+
+    auto reparsed = PARSE_FILE(segments.flatten());
+    ASSERT_EQ(reparsed.records.size(), file.records.size());
+}
+
+TEST(NIST_COW_Reused_Source_Address_Is_Not_Clean) {
+    const auto data = READ_FILE(TEST_DIR "data/valid1.1.an2");
+    std::vector<uint8_t> source = data;
+    const uint8_t* const address = source.data();
+    auto file = PARSE_FILE(source);
+
+    // Unrelated bytes at the very address the File was parsed from, as when
+    // the source is freed and a same-size buffer is allocated in its place.
+    constexpr uint8_t UNRELATED = 0x5A;
+    source.assign(data.size(), UNRELATED);
+    ASSERT_TRUE(source.data() == address);
+
+    for (const auto& record : file.records) {
+        ASSERT_TRUE(!IS_CLEAN_RECORD(record, source));
+    }
+    ASSERT_EQ(SERIALIZE_FILE(file, source), data);
+}
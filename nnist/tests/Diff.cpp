@@ -0,0 +1,77 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+#include <string>
+
+using namespace nnist;
+
+static size_t FIND_TEXT(const std::vector<uint8_t>& data,
+                        const std::string& text) {
+    auto it = std::search(data.begin(), data.end(), text.begin(), text.end());
+    return static_cast<size_t>(it - data.begin());
+}
+
+TEST(NIST_Hash_Matches_XXH64_Vectors) {
+    const std::string abc = "abc";
+    ASSERT_EQ(HASH_BYTES({}), 0xEF46DB3751D8E999ULL);
+    ASSERT_EQ(HASH_BYTES({reinterpret_cast<const uint8_t*>(abc.data()),
+                          abc.size()}),
+              0x44BC2CF5AD770999ULL);
+}
+
+TEST(NIST_Diff_Identical_Transactions_Are_Empty) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.16.an2");
+    auto copy = data;
+    ASSERT_EQ(DIFF_TRANSACTIONS(data, copy).size(), 0U);
+}
+
+TEST(NIST_Diff_Reports_Changed_Field_Offsets) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    auto file = PARSE_FILE(data);
+
+    Record& type2 = EDIT_RECORD(file, 1);
+    for (auto& field : type2.fields) {
+        if (std::string(field.tag.begin(), field.tag.end()) == "2.018") {
+            const std::string name = "smith,thomas";
+            field.subfields[0].items[0].bytes = {name.begin(), name.end()};
+        }
+    }
+    auto edited = SERIALIZE_FILE(file, data);
+
+    auto diff = DIFF_TRANSACTIONS(data, edited);
+
+    // The Type-2 LEN follows the longer name; nothing else moves.
+    ASSERT_EQ(diff.size(), 2U);
+    ASSERT_EQ(diff[0].kind, DIFF_FIELD_CHANGED);
+    ASSERT_EQ(diff[0].type, 2);
+    ASSERT_EQ(diff[0].field_number, 1U);
+    ASSERT_EQ(diff[1].kind, DIFF_FIELD_CHANGED);
+    ASSERT_EQ(diff[1].field_number, 18U);
+    ASSERT_EQ(diff[1].left_offset, FIND_TEXT(data, "2.018:"));
+    ASSERT_EQ(diff[1].right_offset, FIND_TEXT(edited, "2.018:"));
+    ASSERT_EQ(diff[1].right_length, diff[1].left_length + 3U);
+}
+
+TEST(NIST_Diff_Reports_Removed_Records) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    auto file = PARSE_FILE(data);
+    const int removed_type = file.records.back().type;
+
+    file.records.pop_back();
+    UPDATE_CNT_FIELD(file);
+    auto smaller = SERIALIZE_FILE(file);
+
+    auto diff = DIFF_TRANSACTIONS(data, smaller, 2U);
+
+    bool cnt_changed = false;
+    bool record_removed = false;
+    for (const auto& entry : diff) {
+        cnt_changed |= entry.kind == DIFF_FIELD_CHANGED && entry.type == 1 &&
+                       entry.field_number == 3U;
+        record_removed |= entry.kind == DIFF_RECORD_REMOVED &&
+                          entry.type == removed_type &&
+                          entry.right_offset == INVALID_INDEX;
+    }
+    ASSERT_TRUE(cnt_changed);
+    ASSERT_TRUE(record_removed);
+}
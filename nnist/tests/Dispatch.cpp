@@ -0,0 +1,172 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+#include <string>
+#include <type_traits>
+
+using namespace nnist;
+
+static_assert(RecordParser<RECORD_TYPE_4>::IS_BINARY);
+static_assert(RecordParser<RECORD_TYPE_8>::IS_BINARY);
+static_assert(!RecordParser<RECORD_TYPE_14>::IS_BINARY);
+static_assert(RecordParser<RECORD_TYPE_14>::HAS_BINARY_FIELDS);
+static_assert(RecordParser<RECORD_TYPE_14>::IMAGE_FIELD == IMAGE_FIELD_NUMBER);
+static_assert(
+    std::is_base_of_v<ImageRecordParser, RecordParser<RECORD_TYPE_14>>);
+static_assert(
+    std::is_base_of_v<TextRecordParser, RecordParser<RECORD_TYPE_2>>);
+static_assert(!RecordParser<RECORD_TYPE_9>::HAS_BINARY_FIELDS);
+static_assert(RECORD_PARSER_TABLE<RecordParser, HeapStorage>.size() ==
+              MAX_DISPATCH_TYPE + 1U);
+
+// A family that overrides one type and inherits the rest.
+static size_t TYPE2_CALLS = 0U;
+
+template <int TYPE>
+struct TextOnlyType2 : RecordParser<TYPE> {};
+
+template <>
+struct TextOnlyType2<RECORD_TYPE_2> {
+    template <typename Storage>
+    static PARSE_STATUS parse(Cursor& cursor, BasicRecord<Storage>& record) {
+        ++TYPE2_CALLS;
+        return PARSE_RECORD_INTO<false>(cursor, record);
+    }
+};
+
+TEST(NIST_Dispatch_Custom_Parser_Family_Overrides_One_Type) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    const File expected = PARSE_FILE(data);
+
+    File file;
+    TYPE2_CALLS = 0U;
+    ASSERT_EQ(PARSE_FILE_INTO<TextOnlyType2>(std::span<const uint8_t>(data),
+                                             file),
+              PARSE_OK);
+    ASSERT_EQ(TYPE2_CALLS, 1U);
+    ASSERT_EQ(file.records.size(), expected.records.size());
+    ASSERT_TRUE(SERIALIZE_FILE(file, data) == data);
+    for (size_t i = 0; i < file.records.size(); i++) {
+        ASSERT_EQ(file.records[i].type, expected.records[i].type);
+        ASSERT_EQ(file.records[i].fields.size(),
+                  expected.records[i].fields.size());
+        ASSERT_EQ(file.records[i].source_offset,
+                  expected.records[i].source_offset);
+    }
+}
+
+TEST(NIST_Dispatch_Off_Table_Type_Uses_Generic_Parser) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    const RecordLocator locator(data);
+    const auto bytes = locator.bytes(locator.at(1));
+
+    Cursor generic{bytes};
+    Record record;
+    ASSERT_EQ(PARSE_RECORD_OF_TYPE(generic, MAX_DISPATCH_TYPE + 1, record),
+              PARSE_OK);
+    ASSERT_EQ(record.fields.size(), locator.parse(1).fields.size());
+    ASSERT_EQ(record.source_length, bytes.size());
+    ASSERT_EQ(generic.position(), bytes.size());
+}
+
+TEST(NIST_Dispatch_Type1_Parses_Into_Header_Fields) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    const File expected = PARSE_FILE(data);
+
+    Cursor cursor{std::span<const uint8_t>(data)};
+    Record record;
+    Type1Fields header;
+    ASSERT_EQ(RecordParser<RECORD_TYPE_1>::parse(cursor, record, header),
+              PARSE_OK);
+    ASSERT_EQ(record.fields.size(), expected.records[0].fields.size());
+    ASSERT_EQ(header.len, 0U);
+    ASSERT_EQ(header.cnt, FIND_CNT_FIELD(record));
+    ASSERT_EQ(header.at(TYPE1_TCN_FIELD), header.tcn);
+    const auto& tcn = record.fields[header.tcn];
+    ASSERT_EQ(TAG_FIELD_NUMBER(tcn.tag), TYPE1_TCN_FIELD);
+    ASSERT_EQ(std::string(tcn.subfields[0].items[0].bytes.begin(),
+                          tcn.subfields[0].items[0].bytes.end()),
+              "1234567890");
+    ASSERT_EQ(header.at(TYPE1_LEN_FIELD + 100U), INVALID_INDEX);
+}
+
+// A family whose Type-1 parser does not fill Type1Fields itself.
+template <int TYPE>
+struct PlainType1 : RecordParser<TYPE> {};
+
+template <>
+struct PlainType1<RECORD_TYPE_1> {
+    template <typename Storage>
+    static PARSE_STATUS parse(Cursor& cursor, BasicRecord<Storage>& record) {
+        return PARSE_RECORD_INTO(cursor, record);
+    }
+};
+
+TEST(NIST_Dispatch_File_Keeps_Type1_Field_Positions) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    const File file = PARSE_FILE(data);
+
+    ASSERT_EQ(file.type1.cnt, FIND_CNT_FIELD(file.records[0]));
+    const Field* tot = TYPE1_FIELD(file, TYPE1_TOT_FIELD);
+    ASSERT_TRUE(tot != nullptr);
+    ASSERT_EQ(std::string(tot->subfields[0].items[0].bytes.begin(),
+                          tot->subfields[0].items[0].bytes.end()),
+              "CAR");
+    ASSERT_TRUE(TYPE1_FIELD(file, TYPE1_LEN_FIELD + 100U) == nullptr);
+
+    // Families without the Type1Fields overload get them from the tags.
+    File plain;
+    ASSERT_EQ(PARSE_FILE_INTO<PlainType1>(std::span<const uint8_t>(data),
+                                          plain),
+              PARSE_OK);
+    ASSERT_EQ(plain.records.size(), file.records.size());
+    for (const size_t number :
+         {TYPE1_LEN_FIELD, TYPE1_VER_FIELD, TYPE1_CNT_FIELD, TYPE1_TOT_FIELD,
+          TYPE1_DAT_FIELD, TYPE1_ORI_FIELD, TYPE1_TCN_FIELD}) {
+        ASSERT_EQ(plain.type1.at(number), file.type1.at(number));
+    }
+}
+
+TEST(NIST_Dispatch_Tag_Field_Number_Matches_Image_Suffix) {
+    const auto NUMBER = [](const std::string& tag) {
+        return TAG_FIELD_NUMBER(std::span<const uint8_t>(
+            reinterpret_cast<const uint8_t*>(tag.data()), tag.size()));
+    };
+    ASSERT_EQ(NUMBER("14.999"), IMAGE_FIELD_NUMBER);
+    ASSERT_EQ(NUMBER("1.03"), TYPE1_CNT_FIELD);
+    ASSERT_EQ(NUMBER("1.003"), TYPE1_CNT_FIELD);
+    ASSERT_EQ(NUMBER("14.0999"), INVALID_INDEX);
+    ASSERT_EQ(NUMBER("14.999a"), INVALID_INDEX);
+    ASSERT_EQ(NUMBER("999"), INVALID_INDEX);
+    ASSERT_EQ(NUMBER("14."), INVALID_INDEX);
+}
+
+TEST(NIST_Dispatch_Type14_Takes_Image_Field_Up_Front) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    const RecordLocator locator(data);
+    const RecordSpan* span = nullptr;
+    for (size_t i = 0; i < locator.size(); i++) {
+        if (locator.at(i).type == RECORD_TYPE_14) {
+            span = &locator.at(i);
+            break;
+        }
+    }
+    ASSERT_TRUE(span != nullptr);
+    const auto bytes = locator.bytes(*span);
+
+    Cursor specialized{bytes};
+    Record record;
+    ASSERT_EQ(PARSE_RECORD_OF_TYPE(specialized, RECORD_TYPE_14, record),
+              PARSE_OK);
+    ASSERT_EQ(record.source_length, bytes.size());
+    ASSERT_EQ(specialized.position(), bytes.size());
+
+    Cursor generic{bytes};
+    Record reference;
+    ASSERT_EQ(PARSE_RECORD_INTO(generic, reference), PARSE_OK);
+    ASSERT_EQ(record.fields.size(), reference.fields.size());
+    const auto& image = record.fields.back();
+    ASSERT_EQ(TAG_FIELD_NUMBER(image.tag), IMAGE_FIELD_NUMBER);
+    ASSERT_TRUE(image.is_binary_field);
+    ASSERT_TRUE(image.raw_field == reference.fields.back().raw_field);
+}
@@ -0,0 +1,61 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+#include <filesystem>
+
+using namespace nnist;
+
+TEST(NIST_Extract_Locates_Binary_And_Tagged_Payloads) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.16.an2");
+    auto file = PARSE_FILE(data);
+    auto images = LOCATE_IMAGES(data);
+
+    // Type-4, then the .999 field of Types 10, 13-17 and 99.
+    ASSERT_EQ(images.size(), 8U);
+    ASSERT_EQ(images[0].type, 4);
+    ASSERT_EQ(images[0].finger_position, 10);
+    ASSERT_EQ(images[2].type, 13);
+    ASSERT_EQ(images[2].finger_position, 0);
+    ASSERT_EQ(images[3].type, 14);
+    ASSERT_EQ(images[3].finger_position, 13);
+    ASSERT_EQ(images[1].finger_position, -1);
+
+    for (const auto& image : images) {
+        const Record* record = nullptr;
+        for (const auto& candidate : file.records) {
+            if (candidate.type == image.type && candidate.idc == image.idc) {
+                record = &candidate;
+            }
+        }
+        ASSERT_TRUE(record != nullptr);
+
+        const auto payload = std::span<const uint8_t>(data).subspan(
+            image.offset, image.length);
+        const auto& expected = record->is_binary_record
+                                   ? record->raw_record
+                                   : record->fields.back().raw_field;
+        const size_t skip = record->is_binary_record ? 18U : 0U;
+        ASSERT_EQ(payload.size(), expected.size() - skip);
+        ASSERT_TRUE(std::equal(payload.begin(), payload.end(),
+                               expected.begin() + static_cast<long>(skip)));
+    }
+}
+
+TEST(NIST_Extract_Writes_Named_Image_Files) {
+    std::filesystem::path out_dir = TEST_DIR "output/images";
+    std::filesystem::remove_all(out_dir);
+
+    auto extracted = EXTRACT_IMAGES(TEST_DIR "data/valid1.8.an2", out_dir);
+    auto data = READ_FILE(TEST_DIR "data/valid1.8.an2");
+
+    ASSERT_EQ(extracted.size(), 3U);
+    ASSERT_EQ(extracted[0].path.filename().string(),
+              "valid1.8_type14_idc01_fgp13.wsq");
+    for (const auto& image : extracted) {
+        const auto written = READ_FILE(image.path);
+        ASSERT_EQ(written.size(), image.payload.length);
+        ASSERT_TRUE(std::equal(written.begin(), written.end(),
+                               data.begin() + static_cast<long>(
+                                                  image.payload.offset)));
+    }
+}
@@ -0,0 +1,71 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+using namespace nnist;
+
+TEST(NIST_Type1Header_Reads_Bounded_Prefix) {
+    auto header = READ_TYPE1_HEADER(TEST_DIR "data/valid1.11.an2");
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    auto file = PARSE_FILE(data);
+
+    ASSERT_LT(header.bytes_read, data.size());
+    ASSERT_EQ(header.record.type, 1);
+    ASSERT_EQ(header.record.source_length, 178U);
+    ASSERT_TRUE(header.source != nullptr);
+    ASSERT_EQ(header.source->size(), header.bytes_read);
+    ASSERT_EQ(header.record.fields.size(), file.records[0].fields.size());
+    for (size_t f = 0; f < header.record.fields.size(); f++) {
+        ASSERT_EQ(header.record.fields[f].tag, file.records[0].fields[f].tag);
+    }
+
+    ASSERT_EQ(header.plan, PARSE_CNT_PLAN(file.records[0]));
+    ASSERT_EQ(header.plan.size(), 9U);
+    ASSERT_EQ(header.text(TYPE1_TOT_FIELD), "CAR");
+    ASSERT_EQ(header.text(TYPE1_DAT_FIELD), "19990925");
+    ASSERT_EQ(header.text(TYPE1_ORI_FIELD), "NY0303000");
+    ASSERT_EQ(header.text(TYPE1_TCN_FIELD), "1234567890");
+}
+
+TEST(NIST_Type1Header_Keeps_Its_Source_Bytes) {
+    const auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    Type1Header copy;
+    {
+        const auto header = READ_TYPE1_HEADER(TEST_DIR "data/valid1.11.an2");
+        copy = header;
+    }
+
+    // The span outlives READ_TYPE1_HEADER and the header it returned.
+    ASSERT_TRUE(copy.record.source_base == copy.source->data());
+    ASSERT_TRUE(IS_CLEAN_RECORD(copy.record, *copy.source));
+    const auto span = std::span<const uint8_t>(*copy.source)
+                          .subspan(copy.record.source_offset,
+                                   copy.record.source_length);
+    ASSERT_TRUE(std::equal(span.begin(), span.end(), data.begin()));
+}
+
+TEST(NIST_Type1Header_Grows_To_Declared_LEN) {
+    // A one-header-wide first block forces exactly one follow-up read.
+    auto header = READ_TYPE1_HEADER(TEST_DIR "data/valid1.11.an2", 1U);
+
+    ASSERT_EQ(header.bytes_read, 178U);
+    ASSERT_EQ(header.plan.size(), 9U);
+    ASSERT_EQ(header.text(TYPE1_TOT_FIELD), "CAR");
+}
+
+TEST(NIST_Type1Header_Rejects_Truncated_Record) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    data.resize(100U);
+
+    std::filesystem::path out_dir = TEST_DIR "output";
+    std::filesystem::create_directories(out_dir);
+    auto out_path = out_dir / "truncated_type1.an2";
+    WRITE_FILE(out_path, data);
+
+    bool threw = false;
+    try {
+        READ_TYPE1_HEADER(out_path);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+}
@@ -0,0 +1,162 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+using namespace nnist;
+
+static std::string SOCKET_PATH(const std::string& name) {
+    return (std::filesystem::temp_directory_path() /
+            ("nnist_" + name + "_" + std::to_string(::getpid()) + ".sock"))
+        .string();
+}
+
+TEST(NIST_Ingest_Latency_Percentiles_Are_Bounded) {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1U; value <= 1000U; value++) {
+        histogram.record(value);
+    }
+    ASSERT_EQ(histogram.count(), 1000U);
+
+    const uint64_t median = histogram.percentile(0.5);
+    ASSERT_TRUE(median >= 500U && median <= 500U + 500U / 8U);
+    ASSERT_TRUE(histogram.percentile(1.0) >= 1000U);
+    for (uint64_t value : {0ULL, 7ULL, 8ULL, 1000ULL, 123456789ULL}) {
+        const size_t bucket = LatencyHistogram::BUCKET_OF(value);
+        ASSERT_TRUE(LatencyHistogram::BUCKET_LIMIT(bucket) >= value);
+        ASSERT_TRUE(bucket == 0U ||
+                    LatencyHistogram::BUCKET_LIMIT(bucket - 1U) < value);
+    }
+}
+
+TEST(NIST_Ingest_Unix_Socket_Pipelined_Requests) {
+    const std::string path = SOCKET_PATH("pipeline");
+    IngestOptions options;
+    options.unix_path = path;
+    options.worker_count = 4U;
+    IngestServer server(options);
+
+    const std::vector<std::string> names = {"valid1.1", "valid1.8",
+                                            "valid1.11", "type_3_wvu"};
+    std::vector<std::vector<uint8_t>> inputs;
+    for (const auto& name : names) {
+        inputs.push_back(READ_FILE(std::string(TEST_DIR "data/") + name +
+                                   ".an2"));
+    }
+    auto corrupt = inputs[0];
+    corrupt.push_back('X');
+
+    IngestClient client(path);
+    for (const auto& input : inputs) {
+        client.send(input);
+    }
+    client.send(corrupt);
+
+    std::vector<IngestReply> replies(inputs.size() + 1U);
+    for (size_t i = 0; i < replies.size(); i++) {
+        const IngestReply reply = client.receive();
+        ASSERT_TRUE(reply.sequence < replies.size());
+        replies[reply.sequence] = reply;
+    }
+    for (size_t i = 0; i < inputs.size(); i++) {
+        ASSERT_EQ(replies[i].status, INGEST_ACCEPTED);
+        ASSERT_EQ(replies[i].records, PARSE_FILE(inputs[i]).records.size());
+    }
+    ASSERT_EQ(replies.back().status, INGEST_INTEGRITY_FAILED);
+    ASSERT_EQ(replies.back().detail, INTEGRITY_TRAILING_BYTES);
+
+    const IngestStats stats = server.stats();
+    ASSERT_EQ(stats.connections, 1U);
+    ASSERT_EQ(stats.frames, replies.size());
+    ASSERT_EQ(stats.accepted, inputs.size());
+    ASSERT_EQ(stats.rejected, 1U);
+    ASSERT_EQ(server.latency().count(), replies.size());
+}
+
+TEST(NIST_Ingest_Full_Queue_Applies_Backpressure) {
+    const std::string path = SOCKET_PATH("backpressure");
+    IngestOptions options;
+    options.unix_path = path;
+    options.worker_count = 1U;
+    options.queue_capacity = 1U;
+    IngestServer server(options, [](std::span<const uint8_t> frame) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return INGEST_TRANSACTION(frame);
+    });
+
+    auto data = READ_FILE(TEST_DIR "data/valid1.8.an2");
+    constexpr size_t REQUESTS = 32U;
+    IngestClient client(path);
+    for (size_t i = 0; i < REQUESTS; i++) {
+        client.send(data);
+    }
+    std::vector<bool> seen(REQUESTS, false);
+    for (size_t i = 0; i < REQUESTS; i++) {
+        const IngestReply reply = client.receive();
+        ASSERT_EQ(reply.status, INGEST_ACCEPTED);
+        seen[reply.sequence] = true;
+    }
+    for (const bool reply_seen : seen) {
+        ASSERT_TRUE(reply_seen);
+    }
+    ASSERT_TRUE(server.stats().pauses > 0U);
+}
+
+TEST(NIST_Ingest_Latency_Includes_Time_Paused) {
+    const std::string path = SOCKET_PATH("paused_latency");
+    constexpr auto HANDLER_TIME = std::chrono::milliseconds(100);
+    IngestOptions options;
+    options.unix_path = path;
+    options.worker_count = 1U;
+    options.queue_capacity = 1U;
+    IngestServer server(options, [&](std::span<const uint8_t> frame) {
+        std::this_thread::sleep_for(HANDLER_TIME);
+        return INGEST_TRANSACTION(frame);
+    });
+
+    // The third request waits behind two handler runs, one of them with
+    // its connection paused on the full queue.
+    auto data = READ_FILE(TEST_DIR "data/valid1.8.an2");
+    constexpr size_t REQUESTS = 3U;
+    IngestClient client(path);
+    for (size_t i = 0; i < REQUESTS; i++) {
+        client.send(data);
+    }
+    for (size_t i = 0; i < REQUESTS; i++) {
+        ASSERT_EQ(client.receive().status, INGEST_ACCEPTED);
+    }
+    ASSERT_TRUE(server.stats().pauses > 0U);
+
+    const auto slowest = std::chrono::nanoseconds(
+        server.latency().percentile(1.0));
+    ASSERT_TRUE(slowest >= HANDLER_TIME * 5 / 2);
+}
+
+TEST(NIST_Ingest_Localhost_Tcp_And_Oversized_Frames) {
+    IngestOptions options;
+    options.max_frame = 64U;
+    options.worker_count = 1U;
+    IngestServer server(options);
+    ASSERT_TRUE(server.port() != 0U);
+
+    auto data = READ_FILE(TEST_DIR "data/valid1.8.an2");
+    IngestClient client(server.port());
+    client.send(data);
+    const IngestReply reply = client.receive();
+    ASSERT_EQ(reply.status, INGEST_FRAME_TOO_LARGE);
+
+    bool closed = false;
+    try {
+        client.receive();
+    } catch (const std::runtime_error&) {
+        closed = true;
+    }
+    ASSERT_TRUE(closed);
+}
+#endif
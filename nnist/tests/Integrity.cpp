@@ -0,0 +1,83 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+#include <filesystem>
+#include <string>
+
+using namespace nnist;
+
+static size_t FIND_TEXT(const std::vector<uint8_t>& data,
+                        const std::string& text) {
+    auto it = std::search(data.begin(), data.end(), text.begin(), text.end());
+    return static_cast<size_t>(it - data.begin());
+}
+
+TEST(NIST_Integrity_Sample_Files_Are_Sound) {
+    for (const auto& entry :
+         std::filesystem::directory_iterator(TEST_DIR "data")) {
+        auto data = READ_FILE(entry.path());
+        ASSERT_EQ(VALIDATE_INTEGRITY(data).size(), 0U);
+        ASSERT_EQ(FIRST_INTEGRITY_ERROR(data).error, INTEGRITY_OK);
+    }
+}
+
+TEST(NIST_Integrity_Reports_Trailing_Bytes) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    const size_t size = data.size();
+    data.push_back('X');
+
+    const auto error = FIRST_INTEGRITY_ERROR(data);
+    ASSERT_EQ(error.error, INTEGRITY_TRAILING_BYTES);
+    ASSERT_EQ(error.offset, size);
+}
+
+TEST(NIST_Integrity_Reports_Truncation) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    const RecordLocator locator(data);
+    data.resize(data.size() - 1U);
+
+    const auto error = FIRST_INTEGRITY_ERROR(data);
+    ASSERT_EQ(error.error, INTEGRITY_TRUNCATED);
+    ASSERT_EQ(error.record_index, locator.size() - 1U);
+    ASSERT_EQ(error.offset, locator.at(locator.size() - 1U).offset);
+}
+
+TEST(NIST_Integrity_Reports_Cnt_And_Idc_Mismatches) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    const size_t cnt = FIND_TEXT(data, "1.03:") + 5U;
+    data[cnt + 2U] = '8';  // "1<US>9" -> "1<US>8"
+    const size_t idc = FIND_TEXT(data, "2.002:00") + 7U;
+    data[idc] = '7';
+
+    // All-errors mode keeps walking after both; first-error mode stops.
+    const auto errors = VALIDATE_INTEGRITY(data);
+    ASSERT_EQ(errors.size(), 2U);
+    ASSERT_EQ(errors[0].error, INTEGRITY_BAD_CNT);
+    ASSERT_EQ(errors[0].offset, cnt);
+    ASSERT_EQ(errors[1].error, INTEGRITY_IDC_MISMATCH);
+    ASSERT_EQ(errors[1].record_type, 2);
+    ASSERT_EQ(errors[1].offset, idc - 1U);
+    ASSERT_EQ(FIRST_INTEGRITY_ERROR(data).error, INTEGRITY_BAD_CNT);
+}
+
+TEST(NIST_Integrity_Reports_Misplaced_Separators) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    const size_t separator = FIND_TEXT(data, "2.005:") - 1U;
+    data[separator] = FS;  // closes the Type-2 record before its LEN
+
+    const auto errors = VALIDATE_INTEGRITY(data);
+    ASSERT_EQ(errors.size(), 1U);
+    ASSERT_EQ(errors[0].error, INTEGRITY_BAD_SEPARATOR);
+    ASSERT_EQ(errors[0].record_index, 1U);
+    ASSERT_EQ(errors[0].offset, separator);
+}
+
+TEST(NIST_Integrity_Reports_Len_Mismatch) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    const size_t len = FIND_TEXT(data, "2.001:169") + 8U;
+    data[len] = '8';  // LEN now ends one byte short of the FS
+
+    const auto error = FIRST_INTEGRITY_ERROR(data);
+    ASSERT_EQ(error.error, INTEGRITY_LEN_MISMATCH);
+    ASSERT_EQ(error.record_type, 2);
+}
@@ -0,0 +1,63 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+using namespace nnist;
+
+TEST(NIST_MappedFile_Matches_ReadFile) {
+    MappedFile mapped(TEST_DIR "data/valid1.11.an2");
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+
+    ASSERT_EQ(mapped.size(), data.size());
+    ASSERT_TRUE(std::equal(data.begin(), data.end(), mapped.bytes().begin()));
+}
+
+TEST(NIST_Locator_Finds_By_Type_And_IDC) {
+    MappedFile mapped(TEST_DIR "data/valid1.11.an2");
+    RecordLocator locator(mapped.bytes());
+
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    auto file = PARSE_FILE(data);
+
+    ASSERT_EQ(locator.size(), file.records.size());
+
+    // 1.003 plan: 2_00 4_01 10_02 13_03 14_04 15_05 16_06 17_07 99_08
+    auto type14 = locator.parse(14, 4);
+    ASSERT_TRUE(type14.has_value());
+    ASSERT_EQ(type14->type, 14);
+    ASSERT_EQ(type14->idc, 4);
+
+    const Record* expected = nullptr;
+    for (const auto& rec : file.records) {
+        if (rec.type == 14) {
+            expected = &rec;
+        }
+    }
+    ASSERT_TRUE(expected != nullptr);
+    ASSERT_EQ(type14->fields.size(), expected->fields.size());
+    for (size_t f = 0; f < expected->fields.size(); f++) {
+        ASSERT_EQ(type14->fields[f].tag, expected->fields[f].tag);
+        ASSERT_EQ(type14->fields[f].raw_field, expected->fields[f].raw_field);
+    }
+
+    auto type4 = locator.parse(4, 1);
+    ASSERT_TRUE(type4.has_value());
+    ASSERT_TRUE(type4->is_binary_record);
+    ASSERT_EQ(type4->raw_record, file.records[2].raw_record);
+
+    ASSERT_TRUE(locator.find(14, 9) == nullptr);
+    ASSERT_TRUE(!locator.parse(21, 1).has_value());
+}
+
+TEST(NIST_Locator_Ordinal_Access) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.9.an2");
+    RecordLocator locator(data);
+    auto file = PARSE_FILE(data);
+
+    for (size_t i = 0; i < locator.size(); i++) {
+        auto record = locator.parse(i);
+        ASSERT_EQ(record.type, file.records[i].type);
+        ASSERT_EQ(record.idc, file.records[i].idc);
+        ASSERT_EQ(record.fields.size(), file.records[i].fields.size());
+        ASSERT_EQ(record.raw_record.size(), file.records[i].raw_record.size());
+    }
+}
@@ -0,0 +1,49 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+using namespace nnist;
+
+TEST(NIST_Serialized_Record_Size_Is_Exact) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    auto file = PARSE_FILE(data);
+
+    for (const auto& rec : file.records) {
+        std::vector<uint8_t> out;
+        SERIALIZE_RECORD(out, rec);
+        ASSERT_EQ(SERIALIZED_RECORD_SIZE(rec), out.size());
+
+        std::vector<uint8_t> direct(out.size());
+        ASSERT_TRUE(WRITE_RECORD(direct.data(), rec) ==
+                    direct.data() + direct.size());
+        ASSERT_EQ(direct, out);
+    }
+}
+
+TEST(NIST_Parallel_Serialize_Matches_Serial) {
+    std::filesystem::path in_dir = TEST_DIR "data";
+
+    for (auto& entry : std::filesystem::directory_iterator(in_dir)) {
+        auto data = READ_FILE(entry.path());
+        auto serial_file = PARSE_FILE(data);
+        auto parallel_file = PARSE_FILE(data);
+
+        auto serial = SERIALIZE_FILE(serial_file);
+        auto parallel = SERIALIZE_FILE_PARALLEL(parallel_file, 4);
+
+        ASSERT_EQ(parallel, serial);
+    }
+}
+
+TEST(NIST_Parallel_Serialize_To_Mapped_File) {
+    auto data = READ_FILE(TEST_DIR "data/type_3_wvu.an2");
+    auto file = PARSE_FILE(data);
+    auto expected = SERIALIZE_FILE(file);
+
+    std::filesystem::path out_dir = TEST_DIR "output";
+    std::filesystem::create_directories(out_dir);
+    auto out_path = out_dir / "parallel_type_3_wvu.an2";
+
+    SERIALIZE_FILE_PARALLEL(file, out_path, 4);
+
+    ASSERT_EQ(READ_FILE(out_path), expected);
+}
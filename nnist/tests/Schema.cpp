@@ -0,0 +1,79 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+#include <filesystem>
+#include <string>
+
+using namespace nnist;
+
+static_assert(TYPE1_SCHEMA.view().find(9U)->field_number == 9U);
+static_assert(TYPE14_SCHEMA.view().find(999U)->chars == CHARS_B);
+static_assert(TYPE1_SCHEMA.view().find(16U) == nullptr);
+
+TEST(NIST_Schema_Accepts_Sample_Transactions) {
+    for (const auto& entry :
+         std::filesystem::directory_iterator(TEST_DIR "data")) {
+        auto data = READ_FILE(entry.path());
+        ASSERT_EQ(VALIDATE_SCHEMA(data).size(), 0U);
+    }
+}
+
+TEST(NIST_Schema_Reports_Violations_With_Offsets) {
+    const std::string text =
+        "1.001:0\x1D"
+        "1.002:0502\x1D"
+        "1.003:1\x1F"
+        "0\x1D"
+        "1.004:CARCARCARCARCARCAR\x1D"
+        "1.005:1999O925\x1D"
+        "1.007:DAI\x1D"
+        "1.008:ORI\x1D"
+        "1.011:20.00\x1D"
+        "1.012:20.00\x1C";
+    const std::vector<uint8_t> bytes(text.begin(), text.end());
+
+    std::vector<SchemaViolation> raw;
+    VALIDATE_RECORD_SCHEMA(bytes, FIND_SCHEMA(1),
+                           [&](const SchemaViolation& violation) {
+                               raw.push_back(violation);
+                               return true;
+                           });
+
+    ASSERT_EQ(raw.size(), 4U);
+    ASSERT_EQ(raw[0].error, SCHEMA_TOO_FEW_OCCURRENCES);
+    ASSERT_EQ(raw[0].field_number, 3U);
+    ASSERT_EQ(raw[0].offset, text.find("1.003:") + 6U);
+    ASSERT_EQ(raw[1].error, SCHEMA_TOO_LONG);
+    ASSERT_EQ(raw[1].offset, text.find("CARCAR"));
+    ASSERT_EQ(raw[2].error, SCHEMA_BAD_CHARACTER);
+    ASSERT_EQ(raw[2].offset, text.find("O925"));
+    ASSERT_EQ(raw[3].error, SCHEMA_MISSING_FIELD);
+    ASSERT_EQ(raw[3].field_number, 9U);
+
+    // The parsed-record path reports the same violations at the same
+    // offsets.
+    Cursor cursor{bytes};
+    Record record = PARSE_RECORD(cursor);
+    record.type = 1;
+
+    std::vector<SchemaViolation> parsed;
+    VALIDATE_RECORD_SCHEMA(record, [&](const SchemaViolation& violation) {
+        parsed.push_back(violation);
+        return true;
+    });
+    ASSERT_EQ(parsed.size(), raw.size());
+    for (size_t i = 0; i < raw.size(); i++) {
+        ASSERT_EQ(parsed[i].error, raw[i].error);
+        ASSERT_EQ(parsed[i].field_number, raw[i].field_number);
+        ASSERT_EQ(parsed[i].offset, raw[i].offset);
+    }
+
+    // A sink returning false stops at the first violation.
+    size_t seen = 0U;
+    VALIDATE_RECORD_SCHEMA(bytes, FIND_SCHEMA(1),
+                           [&](const SchemaViolation&) {
+                               ++seen;
+                               return false;
+                           });
+    ASSERT_EQ(seen, 1U);
+}
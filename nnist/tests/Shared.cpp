@@ -0,0 +1,144 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+using namespace nnist;
+
+static std::vector<uint8_t> SAMPLE(const std::string& name) {
+    return READ_FILE(std::string(TEST_DIR "data/") + name + ".an2");
+}
+
+TEST(NIST_SharedTransaction_Views_Backing_Buffer) {
+    auto data = SAMPLE("valid1.1");
+    const auto heap = PARSE_FILE(data);
+    const SharedTransaction shared(data);
+
+    ASSERT_EQ(shared.size(), heap.records.size());
+    const auto bytes = shared.bytes();
+    for (size_t r = 0; r < shared.size(); r++) {
+        const ViewRecord& record = shared[r];
+        ASSERT_EQ(record.type, heap.records[r].type);
+        ASSERT_EQ(record.fields.size(), heap.records[r].fields.size());
+        ASSERT_TRUE(std::equal(record.raw_record.begin(),
+                               record.raw_record.end(),
+                               heap.records[r].raw_record.begin(),
+                               heap.records[r].raw_record.end()));
+        for (const ViewField& field : record.fields) {
+            ASSERT_TRUE(field.tag.data() >= bytes.data());
+            ASSERT_TRUE(field.tag.data() + field.tag.size() <=
+                        bytes.data() + bytes.size());
+        }
+    }
+    ASSERT_EQ(shared.record_bytes(2).size(), heap.records[2].source_length);
+}
+
+TEST(NIST_SharedTransaction_Checks_Indexes_And_Empty_Handles) {
+    const SharedTransaction empty;
+    ASSERT_EQ(empty.size(), 0U);
+    ASSERT_TRUE(empty.bytes().empty());
+    ASSERT_TRUE(empty.file().records.empty());
+
+    const SharedTransaction shared(SAMPLE("valid1.1"));
+    for (const SharedTransaction* handle : {&empty, &shared}) {
+        const size_t past_end = handle->size();
+        bool at_threw = false;
+        bool bytes_threw = false;
+        bool record_threw = false;
+        try {
+            static_cast<void>(handle->at(past_end));
+        } catch (const std::out_of_range&) {
+            at_threw = true;
+        }
+        try {
+            static_cast<void>(handle->record_bytes(past_end));
+        } catch (const std::out_of_range&) {
+            bytes_threw = true;
+        }
+        try {
+            static_cast<void>(handle->record(past_end));
+        } catch (const std::out_of_range&) {
+            record_threw = true;
+        }
+        ASSERT_TRUE(at_threw);
+        ASSERT_TRUE(bytes_threw);
+        ASSERT_TRUE(record_threw);
+    }
+    ASSERT_TRUE(&shared.at(0) == &shared[0]);
+}
+
+TEST(NIST_SharedTransaction_Copies_Share_One_Buffer) {
+    SharedTransaction first(SAMPLE("valid1.11"));
+    const uint8_t* buffer = first.bytes().data();
+
+    SharedTransaction second = first;
+    ASSERT_EQ(second.bytes().data(), buffer);
+    ASSERT_EQ(first.use_count(), 2);
+
+    // A record handle alone keeps the buffer alive.
+    auto record = second.record(1);
+    first = SharedTransaction();
+    second = SharedTransaction();
+    ASSERT_FALSE(static_cast<bool>(first));
+    ASSERT_EQ(record->type, 2);
+    ASSERT_TRUE(record->fields[0].tag.data() >= buffer);
+
+    bool threw = false;
+    try {
+        (void)SharedTransaction(SAMPLE("valid1.11")).record(1000U);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+}
+
+TEST(NIST_SharedTransaction_Mapped_And_Heap_Copy) {
+    const auto path = std::string(TEST_DIR "data/valid1.8.an2");
+    const auto mapped = MAP_SHARED_TRANSACTION(path);
+    const auto read = READ_SHARED_TRANSACTION(path);
+    ASSERT_EQ(mapped.size(), read.size());
+    ASSERT_TRUE(std::equal(mapped.bytes().begin(), mapped.bytes().end(),
+                           read.bytes().begin(), read.bytes().end()));
+
+    File copy = mapped.to_file();
+    ASSERT_EQ(copy.records.size(), mapped.size());
+    copy.records[1].dirty = true;
+    ASSERT_FALSE(mapped[1].dirty);
+
+    // Truncated inside the Type-4 record.
+    auto data = SAMPLE("valid1.1");
+    data.resize(data.size() - 100U);
+    bool threw = false;
+    try {
+        const SharedTransaction truncated(std::move(data));
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+}
+
+TEST(NIST_SharedTransaction_Concurrent_Readers) {
+    const SharedTransaction shared(SAMPLE("valid1.11"));
+    std::atomic<size_t> mismatches{0U};
+    constexpr size_t READERS = 64U;
+
+    uint64_t expected = 0U;
+    for (size_t r = 0; r < shared.size(); r++) {
+        expected ^= HASH_BYTES(shared.record_bytes(r));
+    }
+
+    PARALLEL_FOR(READERS, 8U, [&](size_t) {
+        const SharedTransaction local = shared;  // fan-out: one increment
+        uint64_t hash = 0U;
+        for (size_t r = 0; r < local.size(); r++) {
+            hash ^= HASH_BYTES(local.record_bytes(r));
+        }
+        if (hash != expected) {
+            mismatches.fetch_add(1U, std::memory_order_relaxed);
+        }
+    });
+    ASSERT_EQ(mismatches.load(), 0U);
+    ASSERT_EQ(shared.use_count(), 1);
+}
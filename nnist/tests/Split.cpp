@@ -0,0 +1,73 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+using namespace nnist;
+
+static std::vector<uint8_t> CONCAT(const std::vector<const char*>& names,
+                                   std::vector<size_t>& offsets) {
+    std::vector<uint8_t> blob;
+    for (const char* name : names) {
+        auto data = READ_FILE(std::string(TEST_DIR "data/") + name);
+        offsets.push_back(blob.size());
+        blob.insert(blob.end(), data.begin(), data.end());
+    }
+    return blob;
+}
+
+TEST(NIST_Scan_Matches_Parse) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    auto file = PARSE_FILE(data);
+    auto spans = SCAN_TRANSACTION(data);
+
+    ASSERT_EQ(spans.size(), file.records.size());
+    for (size_t i = 0; i < spans.size(); i++) {
+        ASSERT_EQ(spans[i].type, file.records[i].type);
+        ASSERT_EQ(spans[i].idc, file.records[i].idc);
+        ASSERT_EQ(spans[i].is_binary_record, file.records[i].is_binary_record);
+    }
+    ASSERT_EQ(spans.back().offset + spans.back().length, data.size());
+}
+
+TEST(NIST_Split_Concatenated_Transactions) {
+    std::vector<size_t> offsets;
+    auto blob = CONCAT({"valid1.1.an2", "face_jpb_DOM_GMT_DCS.an2",
+                        "type_5_wvu.an2", "valid1.9.an2"},
+                       offsets);
+
+    auto result = SPLIT_TRANSACTIONS(blob);
+
+    ASSERT_TRUE(result.errors.empty());
+    ASSERT_EQ(result.transactions.size(), offsets.size());
+    for (size_t i = 0; i < offsets.size(); i++) {
+        ASSERT_EQ(result.transactions[i].offset, offsets[i]);
+    }
+    ASSERT_EQ(result.transactions[2].record_count, 16);
+
+    auto parsed = PARSE_TRANSACTIONS(blob, result.transactions, 4);
+    ASSERT_EQ(parsed.size(), offsets.size());
+    for (const auto& transaction : parsed) {
+        ASSERT_EQ(transaction.status, PARSE_OK);
+        ASSERT_EQ(transaction.file.records.size(),
+                  transaction.span.record_count);
+    }
+}
+
+TEST(NIST_Split_Resync_After_Corruption) {
+    std::vector<size_t> offsets;
+    auto blob = CONCAT({"valid1.1.an2", "valid1.3.an2", "valid1.4.an2"},
+                       offsets);
+
+    // Break the second transaction's Type-1 LEN.
+    blob[offsets[1] + 5U] = 'x';
+
+    auto strict = SPLIT_TRANSACTIONS(blob);
+    ASSERT_EQ(strict.transactions.size(), 1);
+    ASSERT_EQ(strict.errors.size(), 1);
+    ASSERT_EQ(strict.errors[0].offset, offsets[1]);
+
+    auto resync = SPLIT_TRANSACTIONS(blob, SPLIT_RESYNC);
+    ASSERT_EQ(resync.transactions.size(), 2);
+    ASSERT_EQ(resync.errors.size(), 1);
+    ASSERT_EQ(resync.errors[0].resumed_at, offsets[2]);
+    ASSERT_EQ(resync.transactions[1].offset, offsets[2]);
+}
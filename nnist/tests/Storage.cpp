@@ -0,0 +1,158 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace nnist;
+
+// Part of the core test subset: also built with NNIST_FREESTANDING, where
+// READ_FILE and PARSE_FILE do not exist, so the test reads its own input.
+static std::vector<uint8_t> LOAD(const std::string& name) {
+    std::ifstream file(std::string(TEST_DIR "data/") + name,
+                       std::ios::binary);
+    return {std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>()};
+}
+
+// Capacities are per-file totals.
+using KioskStorage = FixedStorage<16, 256, 256, 512>;
+using KioskFile = BasicFile<KioskStorage>;
+
+// Fixed files are pinned and sizeable; keep them off the test stack.
+static KioskFile FIXED_FILE;
+
+TEST(NIST_InlineVector_Capacity) {
+    InlineVector<int, 2> values;
+
+    ASSERT_TRUE(values.try_push_back(1));
+    ASSERT_TRUE(values.try_push_back(2));
+    ASSERT_TRUE(!values.try_push_back(3));
+    ASSERT_EQ(values.size(), 2);
+    ASSERT_EQ(values.back(), 2);
+    ASSERT_TRUE(values.try_emplace_back() == nullptr);
+
+    values.clear();
+    ASSERT_TRUE(values.empty());
+}
+
+#if !NNIST_FREESTANDING
+TEST(NIST_FixedStorage_Matches_HeapParse) {
+    for (const char* name : {"valid1.1.an2", "valid1.11.an2",
+                             "face_jpb_DOM_GMT_DCS.an2"}) {
+        auto data = LOAD(name);
+        auto heap = PARSE_FILE(data);
+
+        ASSERT_EQ(PARSE_FILE_INTO(std::span<const uint8_t>(data), FIXED_FILE),
+                  PARSE_OK);
+        ASSERT_EQ(FIXED_FILE.records.size(), heap.records.size());
+
+        for (size_t r = 0; r < heap.records.size(); r++) {
+            const auto& A = heap.records[r];
+            const auto& B = FIXED_FILE.records[r];
+
+            ASSERT_EQ(A.type, B.type);
+            ASSERT_EQ(A.idc, B.idc);
+            ASSERT_EQ(A.is_binary_record, B.is_binary_record);
+            ASSERT_TRUE(std::equal(A.raw_record.begin(), A.raw_record.end(),
+                                   B.raw_record.begin(), B.raw_record.end()));
+            ASSERT_EQ(A.fields.size(), B.fields.size());
+
+            for (size_t f = 0; f < A.fields.size(); f++) {
+                const auto& FA = A.fields[f];
+                const auto& FB = B.fields[f];
+
+                ASSERT_TRUE(std::equal(FA.tag.begin(), FA.tag.end(),
+                                       FB.tag.begin(), FB.tag.end()));
+                ASSERT_TRUE(std::equal(FA.raw_field.begin(),
+                                       FA.raw_field.end(),
+                                       FB.raw_field.begin(),
+                                       FB.raw_field.end()));
+                ASSERT_EQ(FA.subfields.size(), FB.subfields.size());
+            }
+        }
+    }
+}
+
+#endif
+
+TEST(NIST_FixedStorage_Borrows_Input_Buffer) {
+    auto data = LOAD("valid1.1.an2");
+
+    ASSERT_EQ(PARSE_FILE_INTO(std::span<const uint8_t>(data), FIXED_FILE),
+              PARSE_OK);
+
+    const auto& raw = FIXED_FILE.records[2].raw_record;
+    ASSERT_TRUE(raw.data() >= data.data());
+    ASSERT_TRUE(raw.data() + raw.size() <= data.data() + data.size());
+}
+
+TEST(NIST_FixedStorage_Reports_Capacity_Exceeded) {
+    static BasicFile<FixedStorage<2, 256, 256, 512>> few_records;
+    static BasicFile<FixedStorage<16, 64, 256, 512>> few_fields;
+    static BasicFile<FixedStorage<16, 256, 256, 128>> few_items;
+    auto data = LOAD("valid1.11.an2");
+
+    ASSERT_EQ(PARSE_FILE_INTO(std::span<const uint8_t>(data), few_records),
+              PARSE_CAPACITY_EXCEEDED);
+    ASSERT_EQ(PARSE_FILE_INTO(std::span<const uint8_t>(data), few_fields),
+              PARSE_CAPACITY_EXCEEDED);
+    ASSERT_EQ(PARSE_FILE_INTO(std::span<const uint8_t>(data), few_items),
+              PARSE_CAPACITY_EXCEEDED);
+}
+
+TEST(NIST_FixedStorage_Pools_Are_Flat_And_Reused) {
+    // Memory is the sum of the pools, not records x fields x ...
+    static_assert(sizeof(KioskFile) < size_t{64} << 10U);
+
+    auto big = LOAD("valid1.11.an2");
+    auto small = LOAD("valid1.1.an2");
+
+    ASSERT_EQ(PARSE_FILE_INTO(std::span<const uint8_t>(big), FIXED_FILE),
+              PARSE_OK);
+    const size_t big_fields = FIXED_FILE.records.pools().fields.size();
+
+    // Parsing again starts from empty pools.
+    ASSERT_EQ(PARSE_FILE_INTO(std::span<const uint8_t>(small), FIXED_FILE),
+              PARSE_OK);
+    size_t fields = 0U;
+    for (const auto& record : FIXED_FILE.records) {
+        fields += record.fields.size();
+    }
+    ASSERT_EQ(FIXED_FILE.records.pools().fields.size(), fields);
+    ASSERT_LT(fields, big_fields);
+
+    // Records own disjoint, consecutive slices of the field pool.
+    const auto* next = FIXED_FILE.records.pools().fields.data();
+    for (const auto& record : FIXED_FILE.records) {
+        if (!record.fields.empty()) {
+            ASSERT_EQ(record.fields.data(), next);
+            next += record.fields.size();
+        }
+    }
+}
+
+TEST(NIST_Invalid_Binary_LEN_Status) {
+    auto data = LOAD("valid1.1.an2");
+    ASSERT_EQ(PARSE_FILE_INTO(std::span<const uint8_t>(data), FIXED_FILE),
+              PARSE_OK);
+    ASSERT_GT(FIXED_FILE.records.size(), 2);
+
+    // Truncate inside the Type-4 record: its LEN now exceeds the buffer.
+    data.resize(data.size() - 100U);
+
+    ASSERT_EQ(PARSE_FILE_INTO(std::span<const uint8_t>(data), FIXED_FILE),
+              PARSE_INVALID_BINARY_LEN);
+
+#if !NNIST_FREESTANDING
+    bool threw = false;
+    try {
+        PARSE_FILE(data);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+#endif
+}
@@ -0,0 +1,184 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+using namespace nnist;
+
+static bool SAME_RECORDS(const File& a, const File& b) {
+    if (a.records.size() != b.records.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.records.size(); i++) {
+        const auto& A = a.records[i];
+        const auto& B = b.records[i];
+        if (A.type != B.type || A.idc != B.idc ||
+            A.raw_record != B.raw_record ||
+            A.fields.size() != B.fields.size()) {
+            return false;
+        }
+        for (size_t f = 0; f < A.fields.size(); f++) {
+            if (A.fields[f].tag != B.fields[f].tag ||
+                A.fields[f].raw_field != B.fields[f].raw_field) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+TEST(NIST_RecordStream_Matches_Parse) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    MemoryByteSource source(data);
+
+    ASSERT_TRUE(SAME_RECORDS(PARSE_STREAM(source), PARSE_FILE(data)));
+}
+
+TEST(NIST_RecordStream_Window_Is_Bounded) {
+    auto data = READ_FILE(TEST_DIR "data/type_3_wvu.an2");
+    MemoryByteSource source(data);
+    RecordStream stream(source, 4096U);
+
+    size_t count = 0;
+    size_t largest = 0;
+    Record record;
+    while (stream.next(record)) {
+        ++count;
+        largest = std::max(largest, record.raw_record.size());
+    }
+
+    ASSERT_EQ(count, 16);
+    ASSERT_LT(stream.peak_window(), data.size() / 4U);
+    ASSERT_GE(stream.peak_window(), largest);
+}
+
+TEST(NIST_RecordStream_Concatenated_Transactions) {
+    auto first = READ_FILE(TEST_DIR "data/valid1.1.an2");
+    auto second = READ_FILE(TEST_DIR "data/valid1.9.an2");
+    first.insert(first.end(), second.begin(), second.end());
+
+    MemoryByteSource source(first);
+    RecordStream stream(source);
+
+    size_t headers = 0;
+    size_t records = 0;
+    Record record;
+    while (stream.next(record)) {
+        headers += record.type == RECORD_TYPE_1 ? 1U : 0U;
+        ++records;
+    }
+
+    ASSERT_EQ(headers, 2);
+    ASSERT_EQ(records, 11);
+}
+
+#if NNIST_HAS_ZLIB
+static std::vector<uint8_t> GZIP(const std::vector<uint8_t>& input) {
+    constexpr int GZIP_WINDOW_BITS = 15 + 16;
+    constexpr int MEMORY_LEVEL = 8;
+
+    z_stream stream{};
+    deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, GZIP_WINDOW_BITS,
+                 MEMORY_LEVEL, Z_DEFAULT_STRATEGY);
+
+    std::vector<uint8_t> out(deflateBound(&stream, (uLong)input.size()));
+    stream.next_in = const_cast<Bytef*>(input.data());
+    stream.avail_in = (uInt)input.size();
+    stream.next_out = out.data();
+    stream.avail_out = (uInt)out.size();
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+TEST(NIST_Gzip_Input_Detected_And_Streamed) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    auto compressed = GZIP(data);
+
+    ASSERT_EQ(DETECT_COMPRESSION(compressed), COMPRESSION_GZIP);
+    ASSERT_EQ(DETECT_COMPRESSION(data), COMPRESSION_NONE);
+
+    auto source = OPEN_DECOMPRESSOR(
+        std::make_unique<MemoryByteSource>(compressed));
+
+    ASSERT_TRUE(SAME_RECORDS(PARSE_STREAM(*source), PARSE_FILE(data)));
+}
+
+TEST(NIST_Gzip_Concatenated_Members) {
+    auto first = READ_FILE(TEST_DIR "data/valid1.3.an2");
+    auto second = READ_FILE(TEST_DIR "data/valid1.4.an2");
+    auto compressed = GZIP(first);
+    auto tail = GZIP(second);
+    compressed.insert(compressed.end(), tail.begin(), tail.end());
+
+    auto source = OPEN_DECOMPRESSOR(
+        std::make_unique<MemoryByteSource>(compressed));
+    RecordStream stream(*source);
+
+    size_t records = 0;
+    Record record;
+    while (stream.next(record)) {
+        ++records;
+    }
+    ASSERT_EQ(records, 6);
+}
+#endif
+
+#if NNIST_HAS_ZSTD
+static std::vector<uint8_t> ZSTD(const std::vector<uint8_t>& input) {
+    constexpr int ZSTD_LEVEL = 1;
+
+    std::vector<uint8_t> out(ZSTD_compressBound(input.size()));
+    const size_t size = ZSTD_compress(out.data(), out.size(), input.data(),
+                                      input.size(), ZSTD_LEVEL);
+    out.resize(ZSTD_isError(size) != 0U ? 0U : size);
+    return out;
+}
+
+TEST(NIST_Zstd_Input_Detected_And_Streamed) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    auto compressed = ZSTD(data);
+
+    ASSERT_EQ(DETECT_COMPRESSION(compressed), COMPRESSION_ZSTD);
+
+    auto source = OPEN_DECOMPRESSOR(
+        std::make_unique<MemoryByteSource>(compressed));
+
+    ASSERT_TRUE(SAME_RECORDS(PARSE_STREAM(*source), PARSE_FILE(data)));
+}
+
+TEST(NIST_Zstd_Concatenated_Frames) {
+    auto first = READ_FILE(TEST_DIR "data/valid1.3.an2");
+    auto second = READ_FILE(TEST_DIR "data/valid1.4.an2");
+    auto compressed = ZSTD(first);
+    auto tail = ZSTD(second);
+    compressed.insert(compressed.end(), tail.begin(), tail.end());
+
+    auto source = OPEN_DECOMPRESSOR(
+        std::make_unique<MemoryByteSource>(compressed));
+    RecordStream stream(*source);
+
+    size_t records = 0;
+    Record record;
+    while (stream.next(record)) {
+        ++records;
+    }
+    ASSERT_EQ(records, 6);
+}
+
+TEST(NIST_Zstd_Truncated_Frame_Throws) {
+    auto data = READ_FILE(TEST_DIR "data/valid1.11.an2");
+    auto compressed = ZSTD(data);
+    compressed.resize(compressed.size() / 2U);
+
+    ZstdByteSource source(std::make_unique<MemoryByteSource>(compressed));
+    std::vector<uint8_t> chunk(4096U);
+    bool threw = false;
+    try {
+        while (source.read(chunk) > 0U) {
+        }
+    } catch (const std::runtime_error& error) {
+        threw = std::string(error.what()) == "Truncated zstd stream";
+    }
+    ASSERT_TRUE(threw);
+}
+#endif
@@ -0,0 +1,99 @@
+#include <nnist/nnist.h>
+#include <NTest.h>
+
+#include <string>
+
+using namespace nnist;
+
+static std::vector<uint8_t> TYPE9_BYTES(const std::string& fields) {
+    const std::string record = fields + "\x1C";
+    return {record.begin(), record.end()};
+}
+
+TEST(NIST_Type9_Decodes_Standard_Minutiae) {
+    MappedFile mapped(TEST_DIR "data/valid1.15.an2");
+    RecordLocator locator(mapped.bytes());
+
+    const RecordSpan* span = nullptr;
+    for (const auto& candidate : locator.spans()) {
+        if (candidate.type == 9) {
+            span = &candidate;
+        }
+    }
+    ASSERT_TRUE(span != nullptr);
+
+    MinutiaeSoA minutiae;
+    ASSERT_EQ(DECODE_MINUTIAE(locator.bytes(*span), minutiae), MINUTIAE_OK);
+
+    // 9.12: 1<US>1250125011231<US>2<US>B<US>1,0
+    ASSERT_EQ(minutiae.size(), 1U);
+    ASSERT_EQ(minutiae.x[0], 12501U);
+    ASSERT_EQ(minutiae.y[0], 25011U);
+    ASSERT_EQ(minutiae.theta[0], 231U);
+    ASSERT_EQ(minutiae.quality[0], 2U);
+    ASSERT_EQ(minutiae.type[0], static_cast<uint8_t>('B'));
+    ASSERT_EQ(minutiae.record_offsets.size(), 2U);
+    ASSERT_EQ(minutiae.record_offsets[1], 1U);
+}
+
+TEST(NIST_Type9_Batch_Fills_Disjoint_Slices) {
+    const auto first = TYPE9_BYTES(
+        "9.001:0\x1D"
+        "9.002:01\x1D"
+        "9.004:S\x1D"
+        "9.010:3\x1D"
+        "9.012:1\x1F"
+        "01000200090\x1F"
+        "5\x1F"
+        "A\x1E"
+        "2\x1F"
+        "03000400180\x1F"
+        "63\x1F"
+        "B\x1E"
+        "3\x1F"
+        "05000600359\x1F"
+        "0\x1F"
+        "D");
+    const auto custom = TYPE9_BYTES(
+        "9.001:0\x1D"
+        "9.002:02\x1D"
+        "9.004:U\x1D"
+        "9.012:1\x1F"
+        "01000200090\x1F"
+        "5\x1F"
+        "A");
+    const auto broken = TYPE9_BYTES(
+        "9.001:0\x1D"
+        "9.002:03\x1D"
+        "9.004:S\x1D"
+        "9.012:1\x1F"
+        "010002X0090\x1F"
+        "5\x1F"
+        "A");
+
+    std::vector<std::span<const uint8_t>> records;
+    for (int i = 0; i < 8; i++) {
+        records.emplace_back(first);
+        records.emplace_back(custom);
+        records.emplace_back(broken);
+    }
+
+    const auto minutiae = DECODE_MINUTIAE_BATCH(records, 4U);
+    ASSERT_EQ(minutiae.size(), 24U);
+    ASSERT_EQ(minutiae.record_status.size(), records.size());
+
+    for (size_t r = 0; r < records.size(); r += 3U) {
+        ASSERT_EQ(minutiae.record_status[r], MINUTIAE_OK);
+        ASSERT_EQ(minutiae.record_status[r + 1U], MINUTIAE_NOT_STANDARD);
+        ASSERT_EQ(minutiae.record_status[r + 2U], MINUTIAE_MALFORMED);
+
+        const size_t base = minutiae.record_offsets[r];
+        ASSERT_EQ(minutiae.record_offsets[r + 1U], base + 3U);
+        ASSERT_EQ(minutiae.record_offsets[r + 3U], base + 3U);
+        ASSERT_EQ(minutiae.x[base + 1U], 300U);
+        ASSERT_EQ(minutiae.y[base + 1U], 400U);
+        ASSERT_EQ(minutiae.theta[base + 2U], 359U);
+        ASSERT_EQ(minutiae.quality[base + 1U], 63U);
+        ASSERT_EQ(minutiae.type[base + 2U], static_cast<uint8_t>('D'));
+    }
+}